@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CALIBRATION_HPP_
+#define CALIBRATION_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace io
+{
+    enum class calibration_kind_t : uint8_t
+    {
+        none,           /**< Raw input values are used as they are. */
+        linear,         /**< Straight line through two points, extended past them. */
+        piecewise,      /**< Straight lines between points, held flat past the first and last. */
+        polynomial      /**< c0 + c1*t + c2*t^2 + c3*t^3, where t = raw / raw_max runs from 0 to 1. */
+    };
+
+    struct calibration_point_t
+    {
+        uint16_t raw = 0u;
+        uint16_t value = 0u;
+    };
+
+    constexpr std::size_t max_calibration_points = 8u;
+    constexpr std::size_t max_polynomial_terms = 4u;
+    constexpr int32_t max_polynomial_coefficient = 1000000;
+
+    /**
+    * Maps an input's raw counts to engineering units, e.g. tenths of a psi.  Values are clamped to [0, 65535].
+    */
+    struct calibration_t
+    {
+        calibration_kind_t kind = calibration_kind_t::none;
+        uint8_t count = 0u;                 /**< Points or polynomial terms in use. */
+        uint16_t raw_max = UINT16_MAX;      /**< Largest raw value the input produces, larger ones are clamped. */
+        std::array<calibration_point_t, max_calibration_points> points{};
+        std::array<int32_t, max_polynomial_terms> coefficients{};
+    };
+
+    constexpr bool valid_calibration(calibration_t const &cal) noexcept
+    {
+        switch (cal.kind)
+        {
+            case calibration_kind_t::none:
+                return true;
+            case calibration_kind_t::linear:
+            case calibration_kind_t::piecewise:
+            {
+                std::size_t const min_points = 2u;
+                std::size_t const max_points = cal.kind == calibration_kind_t::linear ? 2u : max_calibration_points;
+                if (cal.count < min_points || cal.count > max_points || cal.raw_max == 0u)
+                    return false;
+
+                for (std::size_t i = 1u; i != cal.count; ++i)
+                {
+                    if (cal.points[i - 1u].raw >= cal.points[i].raw)
+                        return false;
+                }
+                return cal.points[cal.count - 1u].raw <= cal.raw_max;
+            }
+            case calibration_kind_t::polynomial:
+                return cal.count >= 1u && cal.count <= max_polynomial_terms && cal.raw_max != 0u;
+            default:
+                return false;
+        }
+    }
+
+    /**
+    * A calibration evaluated at 257 evenly spaced raw values when it is built, so a sample costs the same few
+    * integer operations (a multiply, two table reads and an interpolation) whatever the calibration.  Linear
+    * calibrations come out exact to within a count; piecewise ones can be off near their breakpoints by up to the
+    * table's spacing of raw_max / 256.
+    */
+    class calibration_table_t
+    {
+    public:
+        static constexpr std::size_t steps = 256u;
+
+        calibration_table_t() noexcept;
+
+        void build(calibration_t const&) noexcept;
+
+        [[nodiscard]] uint16_t operator()(uint16_t raw) const noexcept
+        {
+            if (identity_)
+                return raw;
+
+            // Table position in 16.16 fixed point, at most steps << 16 so it fits 32 bits.
+            uint32_t const position = static_cast<uint32_t>(raw < raw_max_ ? raw : raw_max_) * step_;
+            std::size_t const index = position >> 16u;
+            int32_t const fraction = static_cast<int32_t>((position & 0xFFFFu) >> 1u);
+            int32_t const low = table_[index];
+            int32_t const high = table_[index + 1u];
+            return static_cast<uint16_t>(low + (((high - low) * fraction) >> 15));
+        }
+
+    private:
+        std::array<uint16_t, steps + 2u> table_;  /**< The last entry repeats the one before, for raw == raw_max. */
+        uint32_t step_;         /**< Table positions per raw count, 16.16 fixed point. */
+        uint16_t raw_max_;
+        bool identity_;
+    };
+}
+
+#endif // CALIBRATION_HPP_
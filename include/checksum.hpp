@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CHECKSUM_HPP_
+#define CHECKSUM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: Kept free of Arduino dependencies so host side tools can share it.
+
+namespace io
+{
+    /**
+    * CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).  Pass the previous result as 'crc' to continue a
+    * checksum over more data.
+    */
+    constexpr uint16_t crc16(uint8_t const *data, std::size_t size, uint16_t crc = 0xFFFFu) noexcept
+    {
+        for (std::size_t i = 0u; i != size; ++i)
+        {
+            crc ^= static_cast<uint16_t>(data[i] << 8u);
+            for (int bit = 0; bit != 8; ++bit)
+                crc = (crc & 0x8000u) ? static_cast<uint16_t>((crc << 1u) ^ 0x1021u) : static_cast<uint16_t>(crc << 1u);
+        }
+        return crc;
+    }
+
+    /**
+    * CRC-32 (IEEE 802.3, reflected, polynomial 0xEDB88320).  Pass the previous result as 'crc' to continue a
+    * checksum over more data.
+    */
+    constexpr uint32_t crc32(uint8_t const *data, std::size_t size, uint32_t crc = 0u) noexcept
+    {
+        crc = ~crc;
+        for (std::size_t i = 0u; i != size; ++i)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit != 8; ++bit)
+                crc = (crc & 1u) ? (crc >> 1u) ^ 0xEDB88320u : crc >> 1u;
+        }
+        return ~crc;
+    }
+}
+
+#endif // CHECKSUM_HPP_
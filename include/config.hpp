@@ -20,36 +20,39 @@
 #define CONFIG_HPP_
 
 #include <chrono>
+#include <optional>
 #include <string_view>
 
 #include <etl/vector.h>
 
+#include "display.hpp"
+#include "drive_profile.hpp"
 #include "logging.hpp"
 #include "modbus_io.hpp"
 #include "pump_state.hpp"
+#include "cycle_analytics.hpp"
+#include "series_recorder.hpp"
+
+#include <SD.h>
 
 namespace io
 {
-
-    struct init_register_t
-    {
-        register_t reg;
-        uint16_t value = 0u;
-    };
-    using init_registers_t = etl::vector<init_register_t, 8u>;
+    constexpr std::size_t max_init_registers = 8u;
+    using init_registers_t = etl::vector<init_register_t, max_init_registers>;
 
 
 
     // Constant expressions for default values.
     constexpr unsigned long modbus_serial_speed = 19200;
     constexpr uint8_t modbus_id = 1u;
-    constexpr io::register_t reg_main_run_sel{ 0x0002 };
-    constexpr io::register_t reg_main_freq_sel{ 0x0005 };
+    inline constexpr drive_profile_t const &default_drive = teco_a510;
     constexpr io::register_t reg_flood{ 0x0C19 };
     constexpr io::register_t reg_pressure{ 0x0C1A };
-    constexpr io::register_t reg_run{ 0x2501 };
-    constexpr io::register_t reg_frequency{ 0x2502 };
+    constexpr io::register_t reg_run = default_drive.run_reg;
+    constexpr io::register_t reg_frequency = default_drive.frequency_reg;
     constexpr uint16_t flood_trigger = 500u;
+    constexpr uint16_t analog_raw_max = 1023u;         /**< analogRead's default 10 bit resolution. */
+    constexpr uint16_t max_drive_frequency = 40000u;   /**< 400Hz in 0.01Hz. */
     constexpr std::chrono::system_clock::duration flood_timeout = std::chrono::minutes(60u);
 
     constexpr control::stepper_levels_t stepper_levels
@@ -71,23 +74,52 @@ namespace io
         }
     };
 
-    constexpr control::run_args_t run_args
-    {
-        .run = 1u,
-        .stop = 0u,
-    };
+    constexpr control::run_args_t run_args = default_drive.run_args;
 
     constexpr pin_size_t cs_pin = 10u;
+    constexpr level_t log_level = level_t::info;
+    constexpr chrono::duration_t log_repeat_window = default_repeat_window;
+
+    /**
+    * Identifies the contents of a JSON configuration file: its size and CRC-32.
+    */
+    struct config_stamp_t
+    {
+        uint32_t size = 0u;
+        uint32_t crc = 0u;
+    };
 
     struct configuration_t
     {
         uint8_t modbus_id = 1u;
         uint32_t modbus_buad = 0u;
+        uint16_t modbus_turnaround_ms = default_drive.turnaround_ms;
+        drive_profile_t const *drive = &default_drive;
         init_registers_t init_registers;
         control::args_t args;
+        recorder_args_t recorder;
+        level_t log_level = io::log_level;
+        chrono::duration_t log_repeat_window = io::log_repeat_window;
+        log_rotation_t log_rotation;
+        control::cycle_args_t cycles;
+        display_args_t display;
+        config_stamp_t json;    /**< The JSON file this was read from. */
     };
 
     configuration_t read_config(std::string_view, modbus_t &, logger_t&) noexcept;
+
+    /**
+    * Parses an open configuration file, as stamped, and refreshes the binary image from it.  The same arena and
+    * limits apply as at boot.
+    */
+    std::optional<configuration_t> parse_config(File&, config_stamp_t, modbus_t&, logger_t&) noexcept;
+
+    /**
+    * Names the first setting that differs between the running configuration and a reloaded one but can only take
+    * effect at boot: the drive, modbus, start-up registers, the run and frequency registers and the inputs.  Nothing
+    * when the reloaded configuration can be applied while running.
+    */
+    std::optional<std::string_view> restart_setting(configuration_t const&, configuration_t const&) noexcept;
 }
 
 #endif // CONFIG_HPP_
\ No newline at end of file
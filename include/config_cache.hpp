@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONFIG_CACHE_HPP_
+#define CONFIG_CACHE_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "config.hpp"
+
+#include <SD.h>
+
+namespace io
+{
+    constexpr char const *config_cache_file = "CONFIG.BIN";
+
+    /**
+    * Reads the file through once to stamp it, leaving it positioned at the start again for parsing.
+    */
+    config_stamp_t stamp_config(File&) noexcept;
+
+    /**
+    * The configuration as it was last parsed from JSON, stored as a single fixed size image with a version and a
+    * CRC-32.  An image is only used when it was compiled from a JSON file with the same stamp by a firmware with the
+    * same image layout.
+    */
+    std::optional<configuration_t> load_config_cache(std::string_view, config_stamp_t, modbus_t&) noexcept;
+    bool store_config_cache(std::string_view, config_stamp_t, configuration_t const&) noexcept;
+}
+
+#endif // CONFIG_CACHE_HPP_
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONFIG_FILTER_HPP_
+#define CONFIG_FILTER_HPP_
+
+#include <cstddef>
+#include <string_view>
+
+// NOTE: Kept free of Arduino dependencies so host side tools can share it.
+
+// Bytes of static RAM the configuration is parsed into, filter included.  The peak use is logged as
+// "config arena peak" after each parse; override with e.g. -D PUMP_CONFIG_ARENA_SIZE=4096 to reclaim the slack.
+#if !defined(PUMP_CONFIG_ARENA_SIZE)
+#define PUMP_CONFIG_ARENA_SIZE 6144
+#endif
+
+namespace io
+{
+    /**
+    * ArduinoJson filter with every key read_config reads, and nothing else, so that anything else in CONFIG.JSN
+    * is skipped over by the parser instead of being stored.  Add new settings here as well as to read_config.
+    */
+    constexpr std::string_view config_filter = R"({
+        "modbus_baud": true,
+        "modbus_id": true,
+        "drive": true,
+        "init_registers": [ { "reg": true, "value": true } ],
+        "run_register": true,
+        "frequency_register": true,
+        "flood_input": { "register": true, "analog_input": true },
+        "pressure_input": { "register": true, "analog_input": true },
+        "pressure_calibration": { "type": true, "raw_max": true, "points": [ { "raw": true, "value": true } ],
+            "coefficients": true },
+        "flood_calibration": { "type": true, "raw_max": true, "points": [ { "raw": true, "value": true } ],
+            "coefficients": true },
+        "stepper_levels":
+        {
+            "stop": { "pressure": true, "frequency": true },
+            "fill": { "pressure": true, "frequency": true },
+            "start": { "pressure": true, "frequency": true }
+        },
+        "run_args": { "run": true, "stop": true },
+        "flood_trigger_value": true,
+        "flood_timeout": true,
+        "max_starts_per_hour": true,
+        "display":
+        {
+            "mode": true,
+            "full_scale_frequency": true,
+            "pressure_decimals": true,
+            "frequency_decimals": true
+        },
+        "log_level": true,
+        "log_repeat_window_s": true,
+        "log_rotation": { "segments": true, "segment_kb": true },
+        "recorder": { "interval_ms": true, "pressure_deadband": true, "heartbeat_s": true }
+    })";
+
+    constexpr std::size_t config_arena_size = PUMP_CONFIG_ARENA_SIZE;
+}
+
+#endif // CONFIG_FILTER_HPP_
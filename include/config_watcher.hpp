@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONFIG_WATCHER_HPP_
+#define CONFIG_WATCHER_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+#include "config.hpp"
+#include "logging.hpp"
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+
+#include <SD.h>
+
+namespace io
+{
+    constexpr chrono::duration_t config_check_interval = std::chrono::seconds(30u);
+    constexpr std::size_t config_read_chunk = 128u;
+
+    using config_handler_t = void (*)(configuration_t const&);
+
+    /**
+    * Watches the configuration file for changes while the controller runs.  Every check stamps the file one chunk
+    * per update, so no update blocks on more than a single SD read while it is unchanged.  Only when the stamp
+    * differs from the configuration in use is the file parsed, from the start in one step as at boot (ArduinoJson
+    * cannot resume a parse), so a file that boots also reloads, and the handler called with the result.
+    */
+    class config_watcher_t
+    {
+    public:
+        config_watcher_t(modbus_t&, logger_t&) noexcept;
+
+        void begin(std::string_view, config_stamp_t, config_handler_t) noexcept;
+        void update(chrono::time_point_t) noexcept;
+
+    private:
+        void start_check() noexcept;
+        void read_chunk() noexcept;
+        void finish_check() noexcept;
+
+        modbus_t &modbus_;
+        logger_t &logger_;
+        char const *filename_;
+        config_handler_t handler_;
+
+        File file_;
+        uint32_t stamped_;
+        config_stamp_t current_;
+        config_stamp_t reading_;
+        chrono::time_point_t next_check_;
+        bool checking_;
+    };
+}
+
+#endif // CONFIG_WATCHER_HPP_
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef COUNTER_STORE_HPP_
+#define COUNTER_STORE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "data_flash.hpp"
+
+namespace io
+{
+    constexpr std::size_t counted_frequencies = 4u;
+
+    struct frequency_time_t
+    {
+        uint16_t frequency = 0u;
+        uint32_t seconds = 0u;
+    };
+
+    /**
+    * Lifetime pump statistics that survive reboots.  Run time is also split by the frequency the pump ran at; once
+    * all entries are taken, time at any other frequency is added to the last one.
+    */
+    struct pump_counters_t
+    {
+        uint32_t starts = 0u;
+        uint32_t run_seconds = 0u;
+        uint32_t flood_trips = 0u;
+        uint32_t modbus_faults = 0u;
+        std::array<frequency_time_t, counted_frequencies> frequencies{};
+    };
+
+    constexpr std::size_t counter_slot_size = 64u;
+    constexpr std::size_t counter_slots_per_block = data_flash_block_size / counter_slot_size;
+    constexpr std::size_t counter_slots = counter_slots_per_block * data_flash_blocks;
+
+    /**
+    * Append-only store of pump_counters_t snapshots in data flash.  Each commit programs the next 64 byte slot with
+    * a sequence number, the counters and a CRC-32.  Blocks are filled in turn and a block is only erased when the
+    * writer moves on to it, so wear is spread over all of data flash and the newest intact snapshot always survives
+    * a power loss.  Finding the newest slot at boot takes the first slot of each block plus a binary search within a
+    * single block, however many times the store has wrapped.
+    */
+    class counter_store_t
+    {
+    public:
+        explicit counter_store_t(data_flash_t&) noexcept;
+
+        [[nodiscard]] std::optional<pump_counters_t> begin() noexcept;
+        [[nodiscard]] bool commit(pump_counters_t const&) noexcept;
+
+    private:
+        struct slot_t
+        {
+            uint32_t sequence = 0u;
+            pump_counters_t counters;
+        };
+
+        [[nodiscard]] bool blank(std::size_t) const noexcept;
+        [[nodiscard]] std::optional<slot_t> read_slot(std::size_t) const noexcept;
+
+        data_flash_t &flash_;
+        std::size_t next_slot_;
+        uint32_t sequence_;
+        bool ready_;
+    };
+}
+
+#endif // COUNTER_STORE_HPP_
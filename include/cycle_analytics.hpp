@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CYCLE_ANALYTICS_HPP_
+#define CYCLE_ANALYTICS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "logging.hpp"
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+
+namespace control
+{
+    struct cycle_args_t
+    {
+        uint16_t max_starts_per_hour = 10u;  /**< More starts than this within an hour raises a short cycling warning. */
+    };
+
+    struct cycle_stats_t
+    {
+        uint32_t starts_hour = 0u;      /**< Starts in the last hour. */
+        uint32_t starts_day = 0u;       /**< Starts in the last 24 hours. */
+        uint32_t mean_run_ms = 0u;      /**< Of runs that ended in the last 24 hours. */
+        uint32_t min_run_ms = 0u;
+        uint32_t mean_off_ms = 0u;      /**< Of off periods that ended in the last 24 hours. */
+        uint32_t min_off_ms = 0u;
+        uint16_t duty_permille = 0u;    /**< Share of the last 24 hours (or of the uptime, if shorter) spent running. */
+    };
+
+    /**
+    * Starts are counted in 5 minute slots for the rolling hour, everything else in hourly buckets for the rolling day.
+    */
+    constexpr chrono::duration_t cycle_slot = std::chrono::minutes(5u);
+    constexpr std::size_t cycle_slots_per_hour = 12u;
+    constexpr std::size_t cycle_hours = 24u;
+
+    /**
+    * Tracks pump run/stop cycles from the pump's samples in fixed memory: starts per hour and per day, run and off
+    * durations, and duty cycle.  Short cycling, more starts in the last hour than allowed, raises a warning on the
+    * display and in the log, and a summary of each hour is logged for tuning the stepper levels.
+    */
+    class cycle_analytics_t
+    {
+    public:
+        explicit cycle_analytics_t(io::logger_t&) noexcept;
+
+        void begin(cycle_args_t) noexcept;
+        void configure(cycle_args_t) noexcept;
+        void record(sample_t const&) noexcept;
+
+        [[nodiscard]] cycle_stats_t stats() const noexcept;
+        void dump_stats(Print&) const noexcept;
+
+    private:
+        struct hour_t
+        {
+            uint16_t starts = 0u;
+            uint16_t runs = 0u;
+            uint16_t offs = 0u;
+            uint32_t run_ms = 0u;       /**< Time spent running within the hour. */
+            uint32_t run_total_ms = 0u; /**< Total length of the runs that ended within the hour. */
+            uint32_t off_total_ms = 0u;
+            uint32_t min_run_ms = std::numeric_limits<uint32_t>::max();
+            uint32_t min_off_ms = std::numeric_limits<uint32_t>::max();
+        };
+
+        void advance(int64_t) noexcept;
+        void report(hour_t const&) noexcept;
+        void check_short_cycling() noexcept;
+        [[nodiscard]] uint32_t starts_hour() const noexcept;
+        [[nodiscard]] hour_t& current_hour() noexcept;
+
+        io::logger_t &logger_;
+        cycle_args_t args_;
+        std::array<uint16_t, cycle_slots_per_hour> slot_starts_;
+        std::array<hour_t, cycle_hours> hours_;
+        int64_t slot_;                          /**< Absolute index of the current 5 minute slot. */
+        int64_t first_ms_;
+        std::optional<int64_t> last_ms_;
+        std::optional<int64_t> transition_ms_;  /**< Time of the last start or stop. */
+        bool running_;
+        bool warned_;
+    };
+}
+
+#endif // CYCLE_ANALYTICS_HPP_
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DATA_FLASH_HPP_
+#define DATA_FLASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(ARDUINO)
+#include <cstdio>
+#endif
+
+namespace io
+{
+    constexpr std::size_t data_flash_block_size = 1024u;
+    constexpr std::size_t data_flash_blocks = 8u;
+    constexpr std::size_t data_flash_size = data_flash_block_size * data_flash_blocks;
+
+#if !defined(ARDUINO)
+    constexpr char const *data_flash_file = "DATAFLASH.BIN";
+#endif
+
+    /**
+    * The RA4M1's 8KB of data flash, separate from program flash.  It is erased a 1KB block at a time, erased bytes
+    * read as 0xFF, and programming can only clear bits.  Host builds stand in a file with the same behaviour.
+    */
+    class data_flash_t
+    {
+    public:
+        data_flash_t() noexcept;
+#if !defined(ARDUINO)
+        ~data_flash_t() noexcept;
+        data_flash_t(data_flash_t const&) = delete;
+        data_flash_t& operator=(data_flash_t const&) = delete;
+#endif
+
+        [[nodiscard]] bool begin() noexcept;
+        void read(uint32_t, void*, std::size_t) const noexcept;
+        [[nodiscard]] bool write(uint32_t, void const*, std::size_t) noexcept;
+        [[nodiscard]] bool erase(std::size_t) noexcept;
+
+    private:
+#if defined(ARDUINO)
+        bool open_;
+#else
+        std::FILE *file_;
+#endif
+    };
+}
+
+#endif // DATA_FLASH_HPP_
@@ -24,29 +24,49 @@
 #include <optional>
 #include <string_view>
 
-#include <etl/circular_buffer.h>
-
+#include "frame_cache.hpp"
+#include "log_format.hpp"
+#include "matrix_sink.hpp"
+#include "message_queue.hpp"
 #include "modbus_io.hpp"
 #include "monotonic_clock.hpp"
-
-// NOTE: PlatformIO's copy of standard Arduino libraries for this platform were stale:
-// "%UserProfile%\.platformio\packages\framework-arduinorenesas-uno\libraries\Arduino_LED_Matrix"
-// so I overwrote it with the one copied from where Arduino IDE installed it at:
-// "%UserProfile%\AppData\Local\Arduino15\packages\arduino\hardware\renesas_uno\1.3.1\libraries\Arduino_LED_Matrix"
-// You may also need to do the same if there are missing method calls of your Arduino_LED_Matrix object.
+#include "scroll_canvas.hpp"
 
 #include "ArduinoGraphics.h"
-#include "Arduino_LED_Matrix.h"
-#include "TextAnimation.h"
 
 namespace io
 {
 
-    struct value_msg_t
+    /**
+    * scroll: every message scrolls across the matrix in turn.
+    * dashboard: pressure, a frequency bar and a fault indicator are shown still and redrawn as soon as they change;
+    * only errors scroll.
+    */
+    enum class display_mode_t : uint8_t
+    {
+        scroll,
+        dashboard
+    };
+
+    constexpr std::optional<display_mode_t> parse_display_mode(std::string_view name) noexcept
+    {
+        if (name == "scroll")
+            return display_mode_t::scroll;
+        if (name == "dashboard")
+            return display_mode_t::dashboard;
+
+        return std::nullopt;
+    }
+
+    constexpr uint8_t max_display_decimals = 4u;
+
+    struct display_args_t
     {
-        std::string_view msg;
-        register_t id;
-        uint64_t value;
+        display_mode_t mode = display_mode_t::scroll;
+        uint16_t full_scale_frequency = 6000u;  /**< Frequency that fills the dashboard's bar. */
+        uint16_t run = 1u;                      /**< Value of the run register while the pump runs. */
+        uint8_t pressure_decimals = 0u;         /**< Implied decimal places of pressure readings. */
+        uint8_t frequency_decimals = 0u;        /**< Implied decimal places of scrolled frequency readings. */
     };
 
     class display_t
@@ -54,26 +74,42 @@ namespace io
     public:
         display_t() noexcept;
 
-        bool begin() noexcept;
+        bool begin(chrono::time_point_t) noexcept;
+        void configure(display_args_t) noexcept;
         void update(chrono::time_point_t) noexcept;
 
-        void set(modbus_error_t) noexcept;
+        void set(modbus_error_t, severity_t = severity_t::fault) noexcept;
         void set(value_msg_t) noexcept;
-        void set(std::string_view) noexcept;
+        void set(std::string_view, severity_t = severity_t::fault) noexcept;
+
+        [[nodiscard]] message_queue_stats_t const& queue_stats() const noexcept  { return queue_.stats(); }
+        void dump_stats(Print&) const noexcept;
+
+#if !defined(ARDUINO)
+        [[nodiscard]] matrix_sink_t& sink() noexcept  { return matrix_; }
+#endif
 
     private:
-        void next(chrono::time_point_t) noexcept;
-        bool has_msg() noexcept;
-        void print_next_msg(ArduinoLEDMatrix &matrix) noexcept;
+        void next(display_msg_t const&, chrono::time_point_t) noexcept;
+        void format(display_msg_t const&, display_text_t&) noexcept;
+        void update_dashboard(value_msg_t) noexcept;
+        void show_dashboard(chrono::time_point_t) noexcept;
 
-        ArduinoLEDMatrix matrix_;
+        matrix_sink_t matrix_;
+        scroll_canvas_t canvas_;
+        frame_cache_t cache_;
         bool next_;
-        uint8_t toggle_msg_;
         chrono::time_point_t next_timeout_;
-        
-        etl::circular_buffer<modbus_error_t,8> errors_;
-        etl::circular_buffer<value_msg_t,8> values_;
-        etl::circular_buffer<std::string_view,8> failures_;
+        chrono::time_point_t now_;      /**< Of begin() or the last update, which queued messages are stamped with. */
+        message_queue_t queue_;
+
+        display_args_t args_;
+        std::optional<uint16_t> pressure_;
+        uint16_t frequency_;
+        bool running_;
+        bool dirty_;
+        bool fault_shown_;
+        chrono::time_point_t fault_until_;
     };
 
 }
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DRIVE_PROFILE_HPP_
+#define DRIVE_PROFILE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "modbus_io.hpp"
+#include "pump_state.hpp"
+
+namespace io
+{
+    struct init_register_t
+    {
+        register_t reg;
+        uint16_t value = 0u;
+    };
+
+    constexpr std::size_t max_profile_init_registers = 4u;
+
+    /**
+    * What differs between VFD brands as far as the controller is concerned.  Frequencies in CONFIG.JSN are always in
+    * 0.01Hz, a drive's frequency register counts in units of 'centihertz_per_unit' of those.
+    */
+    struct drive_profile_t
+    {
+        std::string_view name;
+        register_t run_reg;
+        register_t frequency_reg;
+        control::run_args_t run_args;
+        uint16_t centihertz_per_unit = 1u;
+        uint16_t turnaround_ms = 0u;            /**< Minimum silent time between modbus transactions. */
+        std::array<init_register_t, max_profile_init_registers> init_registers{};
+        uint8_t init_register_count = 0u;
+    };
+
+    /**
+    * TECO A510.  Its modbus implementation needs a much longer silent interval than the protocol's 3.5 characters.
+    * Parameters 00-02 and 00-05 take the run command and frequency from RS-485.
+    */
+    inline constexpr drive_profile_t teco_a510
+    {
+        .name = "teco_a510",
+        .run_reg = register_t{ 0x2501 },
+        .frequency_reg = register_t{ 0x2502 },
+        .run_args = control::run_args_t{ .run = 0x0001u, .stop = 0x0000u },
+        .centihertz_per_unit = 1u,
+        .turnaround_ms = 20u,
+        .init_registers = {{ { register_t{ 0x0002 }, 3u }, { register_t{ 0x0005 }, 2u } }},
+        .init_register_count = 2u
+    };
+
+    /**
+    * Delta C2000 family.  The command word takes 01b to stop and 10b to run, and parameters 00-20 and 00-21 take
+    * the frequency and run command from RS-485.
+    */
+    inline constexpr drive_profile_t delta_c2000
+    {
+        .name = "delta_c2000",
+        .run_reg = register_t{ 0x2000 },
+        .frequency_reg = register_t{ 0x2001 },
+        .run_args = control::run_args_t{ .run = 0x0002u, .stop = 0x0001u },
+        .centihertz_per_unit = 1u,
+        .turnaround_ms = 5u,
+        .init_registers = {{ { register_t{ 0x0014 }, 1u }, { register_t{ 0x0015 }, 2u } }},
+        .init_register_count = 2u
+    };
+
+    inline constexpr std::array<drive_profile_t const*, 2u> drive_profiles{ &teco_a510, &delta_c2000 };
+
+    constexpr drive_profile_t const* find_drive_profile(std::string_view name) noexcept
+    {
+        for (drive_profile_t const *profile : drive_profiles)
+        {
+            if (profile->name == name)
+                return profile;
+        }
+        return nullptr;
+    }
+
+    constexpr uint16_t to_drive_frequency(drive_profile_t const &profile, uint16_t centihertz) noexcept
+    {
+        return static_cast<uint16_t>(centihertz / profile.centihertz_per_unit);
+    }
+
+    constexpr bool valid_profile(drive_profile_t const &profile) noexcept
+    {
+        return !profile.name.empty() && profile.run_args.run != profile.run_args.stop &&
+            profile.centihertz_per_unit != 0u && profile.init_register_count <= max_profile_init_registers &&
+            profile.run_reg.address != profile.frequency_reg.address;
+    }
+
+    static_assert(valid_profile(teco_a510) && valid_profile(delta_c2000), "invalid built-in drive profile");
+    static_assert(find_drive_profile("teco_a510") == &teco_a510, "drive profile names must be unique");
+    static_assert(find_drive_profile("delta_c2000") == &delta_c2000, "drive profile names must be unique");
+}
+
+#endif // DRIVE_PROFILE_HPP_
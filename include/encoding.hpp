@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ENCODING_HPP_
+#define ENCODING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: Kept free of Arduino dependencies so host side tools can share it.
+
+namespace io
+{
+    constexpr std::size_t max_varint_size = 10u;
+
+    /**
+    * Map signed values onto unsigned ones so that small magnitudes of either sign encode to few varint bytes.
+    */
+    constexpr uint64_t zigzag_encode(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    constexpr int64_t zigzag_decode(uint64_t value) noexcept
+    {
+        return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+    }
+
+    /**
+    * LEB128 style varint: 7 bits per byte, least significant group first, high bit set on all but the last byte.
+    * Returns the number of bytes written, or 0 if there was not enough room.
+    */
+    constexpr std::size_t encode_varint(uint64_t value, uint8_t *out, std::size_t size) noexcept
+    {
+        std::size_t count = 0u;
+        do
+        {
+            if (count == size)
+                return 0u;
+
+            uint8_t byte = static_cast<uint8_t>(value & 0x7Fu);
+            value >>= 7u;
+            if (value != 0u)
+                byte |= 0x80u;
+            out[count++] = byte;
+        } while (value != 0u);
+
+        return count;
+    }
+
+    /**
+    * Returns the number of bytes consumed, or 0 if the input ended mid value or the value was too long.
+    */
+    constexpr std::size_t decode_varint(uint8_t const *in, std::size_t size, uint64_t &value) noexcept
+    {
+        value = 0u;
+        for (std::size_t i = 0u; i != size && i != max_varint_size; ++i)
+        {
+            value |= static_cast<uint64_t>(in[i] & 0x7Fu) << (7u * i);
+            if ((in[i] & 0x80u) == 0u)
+                return i + 1u;
+        }
+        return 0u;
+    }
+
+    /**
+    * Fixed width little endian fields, for headers that are read back without parsing the whole stream.
+    */
+    template <class T>
+    constexpr void store_le(T value, uint8_t *out) noexcept
+    {
+        for (std::size_t i = 0u; i != sizeof(T); ++i)
+            out[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8u * i));
+    }
+
+    template <class T>
+    constexpr T load_le(uint8_t const *in) noexcept
+    {
+        uint64_t value = 0u;
+        for (std::size_t i = 0u; i != sizeof(T); ++i)
+            value |= static_cast<uint64_t>(in[i]) << (8u * i);
+        return static_cast<T>(value);
+    }
+}
+
+#endif // ENCODING_HPP_
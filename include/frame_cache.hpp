@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FRAME_CACHE_HPP_
+#define FRAME_CACHE_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <etl/string.h>
+#include <etl/vector.h>
+
+#include "message_queue.hpp"
+
+// Frames are 16 bytes each; the default pool of 320 frames holds the run, frequency, pressure and flood readings
+// the display cycles through.  Override with e.g. -D PUMP_FRAME_CACHE_FRAMES=200 to trade hits for RAM.
+#if !defined(PUMP_FRAME_CACHE_FRAMES)
+#define PUMP_FRAME_CACHE_FRAMES 320
+#endif
+
+namespace io
+{
+    constexpr uint32_t frame_cache_frames = PUMP_FRAME_CACHE_FRAMES;
+    constexpr std::size_t frame_cache_entries = 8u;
+
+    constexpr int matrix_width = 12;
+    constexpr int matrix_height = 8;
+
+    /**
+    * LED matrix animation frame: three words of packed pixels and the frame duration.
+    */
+    using frame_t = uint32_t[4];
+
+    struct frame_cache_stats_t
+    {
+        uint32_t hits = 0u;
+        uint32_t misses = 0u;
+        uint32_t evictions = 0u;
+    };
+
+    /**
+    * LRU cache of rendered scroll animations keyed by the text that was rendered.  Animations are rendered straight
+    * into the cache's frame pool and played from there, so the pool doubles as the display's animation buffer.
+    * Entries are kept packed in pool order; evicting one slides the later entries down.  The entry the matrix is
+    * playing is never moved: an entry before it is dropped where it is, leaving a gap until the playing entry has
+    * finished and a later eviction packs the pool again.
+    */
+    class frame_cache_t
+    {
+    public:
+        struct entry_t
+        {
+            frame_t *frames;
+            uint32_t bytes;
+        };
+
+        frame_cache_t() noexcept;
+
+        [[nodiscard]] std::optional<entry_t> find(std::string_view) noexcept;
+        [[nodiscard]] entry_t reserve(std::string_view, uint32_t) noexcept;
+        [[nodiscard]] std::optional<entry_t> commit(uint32_t) noexcept;
+
+        /**
+        * The frames the matrix is reading, or nullptr once it no longer is.
+        */
+        void set_playing(frame_t const *frames) noexcept  { playing_ = frames; }
+
+        [[nodiscard]] frame_cache_stats_t const& stats() const noexcept  { return stats_; }
+
+    private:
+        struct slot_t
+        {
+            display_text_t text;
+            uint16_t first;
+            uint16_t count;
+            uint32_t last_used;
+        };
+
+        [[nodiscard]] uint32_t end() const noexcept;
+        [[nodiscard]] entry_t entry(slot_t const&) noexcept;
+        [[nodiscard]] bool evict() noexcept;
+
+        etl::vector<slot_t, frame_cache_entries> slots_;
+        frame_t frames_[frame_cache_frames];
+        uint32_t tick_;
+        frame_t const *playing_;
+        frame_cache_stats_t stats_;
+    };
+}
+
+#endif // FRAME_CACHE_HPP_
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef JSON_ARENA_HPP_
+#define JSON_ARENA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ArduinoJson.h>
+
+// NOTE: Kept free of Arduino dependencies so host side tools can share it.
+
+namespace io
+{
+    /**
+    * Bump allocator for ArduinoJson over a caller provided buffer, so a document can never take more memory than
+    * the buffer holds: an allocation that does not fit fails, and the parse reports NoMemory.  Memory is only given
+    * back by reset(), apart from the most recent block, which can also be grown, shrunk or freed in place (what
+    * ArduinoJson does with the string it is building and with its pools once a parse is done).  The peak and failure
+    * counts are also cleared by reset(), so they describe a single parse.
+    */
+    class json_arena_t : public ArduinoJson::Allocator
+    {
+    public:
+        json_arena_t(void *buffer, std::size_t size) noexcept;
+
+        void* allocate(std::size_t) override;
+        void deallocate(void*) override;
+        void* reallocate(void*, std::size_t) override;
+
+        void reset() noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept  { return size_; }
+        [[nodiscard]] std::size_t used() const noexcept      { return used_; }
+        [[nodiscard]] std::size_t peak() const noexcept      { return peak_; }
+        [[nodiscard]] uint32_t failures() const noexcept     { return failures_; }
+
+    private:
+        [[nodiscard]] bool last(void const*) const noexcept;
+        [[nodiscard]] std::size_t block_size(void const*) const noexcept;
+        void set_used(std::size_t) noexcept;
+
+        uint8_t *buffer_;
+        std::size_t size_;
+        std::size_t used_;
+        std::size_t last_;
+        std::size_t peak_;
+        uint32_t failures_;
+    };
+}
+
+#endif // JSON_ARENA_HPP_
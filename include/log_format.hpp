@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LOG_FORMAT_HPP_
+#define LOG_FORMAT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "checksum.hpp"
+#include "encoding.hpp"
+
+// NOTE: Kept free of Arduino dependencies so the host side log decoder can share it.
+
+namespace io
+{
+    /**
+    * Binary log records are framed as [type:u8][length:u8][sequence:u8][payload:length bytes][crc:u16 le], where the
+    * sequence number increments by one per record and the CRC-16 covers everything before it.  Every payload starts
+    * with a varint
+    * timestamp: the absolute monotonic milliseconds for session and segment records, otherwise the milliseconds
+    * elapsed since the previous record.  The remaining fields are varints in the order listed below, unless noted
+    * otherwise.  Records never straddle a 512 byte sector, the rest of a sector that cannot hold the next record is
+    * zero padding.
+    */
+    enum class record_t : uint8_t
+    {
+        padding = 0u,       /**< Reserved, never written as a record. */
+        session = 1u,       /**< Start of a controller run. */
+        message = 2u,       /**< msg */
+        message_value = 3u, /**< msg, value */
+        text = 4u,          /**< raw bytes of a message that was not interned */
+        value = 5u,         /**< msg, register, value */
+        modbus_error = 6u,  /**< modbus error code, source line */
+        failure = 7u,       /**< msg */
+        failure_text = 8u,  /**< raw bytes */
+        profile = 9u,       /**< scope, count, min, mean, max, histogram counts... */
+        log_stats = 10u,    /**< records, high water, dropped */
+        repeated = 11u,     /**< modbus error code, source line, suppressed count, duration ms */
+        segment = 12u       /**< First record of a log segment, with an absolute time: sequence number */
+    };
+
+    constexpr bool absolute_time(record_t type) noexcept
+    {
+        return type == record_t::session || type == record_t::segment;
+    }
+
+    constexpr std::size_t sector_size = 512u;
+    constexpr std::size_t record_header_size = 3u;
+    constexpr std::size_t record_trailer_size = 2u;
+    constexpr std::size_t max_record_payload = 255u;
+    constexpr std::size_t max_record_size = record_header_size + max_record_payload + record_trailer_size;
+
+    constexpr std::size_t record_size(uint8_t length) noexcept
+    {
+        return record_header_size + length + record_trailer_size;
+    }
+
+    /**
+    * True if a complete record with a matching CRC starts at 'frame', given 'available' readable bytes.
+    */
+    constexpr bool record_intact(uint8_t const *frame, std::size_t available) noexcept
+    {
+        if (available < record_header_size + record_trailer_size || frame[0] == static_cast<uint8_t>(record_t::padding))
+            return false;
+
+        std::size_t const size = record_size(frame[1]);
+        if (size > available)
+            return false;
+
+        std::size_t const covered = size - record_trailer_size;
+        return crc16(frame, covered) == load_le<uint16_t>(frame + covered);
+    }
+
+    /**
+    * Messages that are logged from fixed strings are interned: only their index in this table is written.  Append
+    * new messages to the end so old logs keep decoding.
+    */
+    enum class msg_id_t : uint8_t
+    {
+        unknown = 0u
+    };
+
+    constexpr std::array<std::string_view, 25u> messages
+    {
+        "",
+        "-- pump controller startup --",
+        "SD init failed",
+        "pressure: ",
+        "flood: ",
+        "run: ",
+        "frequency: ",
+        "log rollover us: ",
+        "pump starts: ",
+        "pump run hours: ",
+        "short cycling",
+        "cycle starts/h: ",
+        "cycle duty %: ",
+        "cycle min run s: ",
+        "cycle min off s: ",
+        "config from cache",
+        "config ms: ",
+        "boot ms: ",
+        "config reloaded",
+        "config rejected",
+        "config too large",
+        "config arena peak: ",
+        "config errors: ",
+        "init register: ",
+        "config needs restart"
+    };
+
+    constexpr msg_id_t intern(std::string_view text) noexcept
+    {
+        for (std::size_t i = 1u; i != messages.size(); ++i)
+        {
+            if (messages[i] == text)
+                return static_cast<msg_id_t>(i);
+        }
+        return msg_id_t::unknown;
+    }
+
+    constexpr std::string_view message_text(msg_id_t id) noexcept
+    {
+        std::size_t const index = static_cast<std::size_t>(id);
+        return index < messages.size() ? messages[index] : messages[0];
+    }
+
+    /**
+    * Builds a single record in a caller owned buffer.  Fields that do not fit mark the record as overflowed.
+    */
+    class record_writer_t
+    {
+    public:
+        constexpr record_writer_t(record_t type, uint64_t time) noexcept
+        : buffer_{}, size_(record_header_size), overflow_(false)
+        {
+            buffer_[0] = static_cast<uint8_t>(type);
+            put(time);
+        }
+
+        constexpr void put(uint64_t value) noexcept
+        {
+            std::size_t const count = encode_varint(value, buffer_.data() + size_, capacity() - size_);
+            if (count == 0u)
+                overflow_ = true;
+            size_ += count;
+        }
+
+        constexpr void put_signed(int64_t value) noexcept
+        {
+            put(zigzag_encode(value));
+        }
+
+        constexpr void put_bytes(uint8_t const *data, std::size_t count) noexcept
+        {
+            if (count > capacity() - size_)
+            {
+                overflow_ = true;
+                count = capacity() - size_;
+            }
+            for (std::size_t i = 0u; i != count; ++i)
+                buffer_[size_++] = data[i];
+        }
+
+        [[nodiscard]] constexpr record_t type() const noexcept      { return static_cast<record_t>(buffer_[0]); }
+        [[nodiscard]] constexpr bool overflowed() const noexcept    { return overflow_; }
+        [[nodiscard]] constexpr std::size_t size() const noexcept   { return size_ + record_trailer_size; }
+
+        /**
+        * Fills in the length, sequence number and CRC and returns the complete record, ready to be written.
+        */
+        [[nodiscard]] constexpr uint8_t const* frame(uint8_t sequence) noexcept
+        {
+            buffer_[1] = static_cast<uint8_t>(size_ - record_header_size);
+            buffer_[2] = sequence;
+            store_le(crc16(buffer_.data(), size_), buffer_.data() + size_);
+            return buffer_.data();
+        }
+
+    private:
+        [[nodiscard]] constexpr std::size_t capacity() const noexcept { return buffer_.size() - record_trailer_size; }
+
+        std::array<uint8_t, max_record_size> buffer_;
+        std::size_t size_;
+        bool overflow_;
+    };
+
+    /**
+    * Reads the varint fields of a single record's payload.
+    */
+    class record_reader_t
+    {
+    public:
+        constexpr record_reader_t(uint8_t const *payload, std::size_t size) noexcept
+        : data_(payload), size_(size), offset_(0u), error_(false)
+        {}
+
+        constexpr uint64_t get() noexcept
+        {
+            uint64_t value = 0u;
+            std::size_t const count = decode_varint(data_ + offset_, size_ - offset_, value);
+            if (count == 0u)
+                error_ = true;
+            offset_ += count;
+            return value;
+        }
+
+        constexpr int64_t get_signed() noexcept
+        {
+            return zigzag_decode(get());
+        }
+
+        [[nodiscard]] constexpr bool error() const noexcept                 { return error_; }
+        [[nodiscard]] constexpr bool at_end() const noexcept                { return offset_ == size_; }
+        [[nodiscard]] constexpr uint8_t const* remaining() const noexcept   { return data_ + offset_; }
+        [[nodiscard]] constexpr std::size_t remaining_size() const noexcept { return size_ - offset_; }
+
+    private:
+        uint8_t const *data_;
+        std::size_t size_;
+        std::size_t offset_;
+        bool error_;
+    };
+}
+
+/**
+* Interns a message string at compile time, failing the build if it has not been added to io::messages.
+*/
+#define LOG_MSG(text) ([]() constexpr \
+    { \
+        constexpr io::msg_id_t id = io::intern(text); \
+        static_assert(id != io::msg_id_t::unknown, "log message not interned in io::messages"); \
+        return id; \
+    }())
+
+#endif // LOG_FORMAT_HPP_
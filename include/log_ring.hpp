@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LOG_RING_HPP_
+#define LOG_RING_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <Arduino.h>
+
+#include "log_format.hpp"
+
+namespace io
+{
+    constexpr std::size_t log_ring_size = 4u * sector_size;
+
+    struct log_ring_stats_t
+    {
+        uint32_t high_water = 0u;   /**< Most bytes ever waiting in the ring. */
+        uint32_t dropped = 0u;      /**< Records discarded because the ring was full. */
+        uint32_t records = 0u;      /**< Records committed to the ring. */
+    };
+
+    /**
+    * Fixed size byte ring that log records are formatted into before being written out to SD.  A record is
+    * committed whole or not at all: if it does not fit, it is rolled back and counted as dropped.
+    */
+    class log_ring_t : public Print
+    {
+    public:
+        log_ring_t() noexcept;
+
+        void begin_record() noexcept;
+        bool end_record() noexcept;
+
+        size_t write(uint8_t) override;
+        size_t write(uint8_t const*, size_t) override;
+        using Print::write;
+
+        [[nodiscard]] std::size_t size() const noexcept          { return size_; }
+        [[nodiscard]] bool empty() const noexcept                { return size_ == 0u; }
+        [[nodiscard]] log_ring_stats_t const& stats() const noexcept   { return stats_; }
+
+        [[nodiscard]] std::size_t contiguous() const noexcept;
+        [[nodiscard]] uint8_t const* front() const noexcept      { return buffer_.data() + head_; }
+        void consume(std::size_t) noexcept;
+
+    private:
+        std::array<uint8_t, log_ring_size> buffer_;
+        std::size_t head_;      /**< Index of the oldest committed byte. */
+        std::size_t size_;      /**< Committed bytes. */
+        std::size_t pending_;   /**< Bytes of the record currently being formatted. */
+        bool overflow_;
+        log_ring_stats_t stats_;
+    };
+}
+
+#endif // LOG_RING_HPP_
@@ -20,12 +20,21 @@
 #define LOGGING_HPP_
 
 #include <array>
+#include <chrono>
+#include <optional>
 #include <string_view>
 
 #include <tl/expected.hpp>
 
+#include <etl/vector.h>
+
 #include "display.hpp"
+#include "log_format.hpp"
+#include "log_ring.hpp"
 #include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+#include "profiler.hpp"
+#include "repeat_filter.hpp"
 
 #include <SPI.h>
 #include <SD.h>
@@ -33,36 +42,307 @@
 
 namespace io
 {
-    constexpr char *log_file_path = "PMPCTRL.LOG";
+    constexpr char const *log_file_base = "PMPCTRL";
+
+    /**
+    * The log is split into segments PMPCTRL.000, PMPCTRL.001 ... that are reused round robin.  Each segment starts
+    * with a segment record holding its sequence number.  The segment after the active one is zero filled in the
+    * background before it is needed, so at most segments - 1 of them hold history.  A segment that is needed before
+    * its fill is done grows as it is written instead.
+    */
+    struct log_rotation_t
+    {
+        uint8_t segments = 4u;
+        uint32_t segment_size = 256u * 1024u;
+    };
+
+    constexpr uint8_t max_log_segments = 16u;
+    constexpr uint32_t min_segment_size = 8u * sector_size;
+
+    /**
+    * Buffered records are written out a sector at a time, or all at once when the oldest buffered record has waited
+    * this long, in which case the file is flushed on the following update.
+    */
+    constexpr std::chrono::seconds log_max_age{ 4u };
+
+    /**
+    * Number of registers whose last logged value is remembered, so unchanged values are not logged again.
+    */
+    constexpr std::size_t max_logged_values = 8u;
+
+    enum class level_t : uint8_t
+    {
+        trace,
+        debug,
+        info,
+        warning,
+        error,
+        off
+    };
+
+    // Log sites below this level are compiled out entirely.  Override with e.g. -D PUMP_LOG_LEVEL=1 for debug.
+#if !defined(PUMP_LOG_LEVEL)
+#define PUMP_LOG_LEVEL 2
+#endif
+    constexpr level_t min_log_level = static_cast<level_t>(PUMP_LOG_LEVEL);
+
+    template <level_t L>
+    constexpr bool log_enabled = (L >= min_log_level) && (L != level_t::off);
+
+    // Messages logged at warning or above are shown on the display too, whether or not they are written to the log.
+    template <level_t L>
+    constexpr bool log_displayed = (L >= level_t::warning) && (L != level_t::off);
+
+    // Errors and failures logged below level_t::error are shown on the display as warnings.
+    template <level_t L>
+    constexpr severity_t display_severity = (L >= level_t::error) ? severity_t::fault : severity_t::warning;
+
+    constexpr std::optional<level_t> parse_level(std::string_view name) noexcept
+    {
+        if (name == "trace")
+            return level_t::trace;
+        if (name == "debug")
+            return level_t::debug;
+        if (name == "info")
+            return level_t::info;
+        if (name == "warning")
+            return level_t::warning;
+        if (name == "error")
+            return level_t::error;
+        if (name == "off")
+            return level_t::off;
+
+        return std::nullopt;
+    }
+
+    /**
+    * Writes binary log records (see log_format.hpp) to the SD card and forwards anything user facing to the display.
+    * Each log call has a severity level: calls below min_log_level compile to nothing (other than updating the
+    * display), and calls below the runtime level set from the config are skipped.  Modbus errors, failures and
+    * register values always reach the display; a message, a message with a value or a text does when logged at
+    * warning or above, as a warning or fault, without being a failure record.  Profiles are never shown.  Modbus
+    * errors are deduplicated per log site: a repeat within the repeat window is only counted, and the count logged
+    * once the window closes.
+    */
     class logger_t
     {
     public:
-        logger_t(display_t&) noexcept;
+        logger_t(display_t&, chrono::monotonic_clock_t&) noexcept;
 
         void begin_log(std::string_view) noexcept;
+        void set_rotation(log_rotation_t) noexcept;
+        void set_level(level_t) noexcept;
+        void set_repeat_window(chrono::duration_t) noexcept;
+
+        template <level_t L = level_t::error, class T>
+        void log_on_error(tl::expected<T,modbus_error_t> const&, log_site_t = log_site_t::current()) noexcept;
 
-        template <class T>
-        void log_on_error(tl::expected<T,modbus_error_t> const&) noexcept;
+        template <level_t L = level_t::error>
+        void log_on_failure(bool, msg_id_t) noexcept;
 
+        template <level_t L = level_t::error>
         void log_on_failure(bool, std::string_view) noexcept;
 
-        void log(modbus_error_t) noexcept;
+        template <level_t L = level_t::error>
+        void log(modbus_error_t, log_site_t = log_site_t::current()) noexcept;
+
+        template <level_t L = level_t::debug>
         void log(value_msg_t) noexcept;
+
+        template <level_t L = level_t::info>
+        void log(msg_id_t) noexcept;
+
+        template <level_t L = level_t::info>
+        void log(msg_id_t, std::uint32_t) noexcept;
+
+        template <level_t L = level_t::info>
         void log(std::string_view) noexcept;
-        void log(std::string_view, std::uint32_t) noexcept;
 
+        template <level_t L = level_t::info>
+        void log(chrono::profiler_t const&) noexcept;
+
+        void update(chrono::time_point_t) noexcept;
         void flush() noexcept;
 
+        [[nodiscard]] log_ring_stats_t const& stats() const noexcept   { return ring_.stats(); }
+        void dump_stats(Print&) const noexcept;
+
     private:
+        struct logged_value_t
+        {
+            register_t id;
+            uint64_t value = 0u;
+        };
+
+        template <level_t L>
+        [[nodiscard]] bool enabled() const noexcept;
+
+        void write(modbus_error_t, log_site_t) noexcept;
+        void write(repeat_summary_t const&) noexcept;
+        void write(value_msg_t) noexcept;
+        void write(msg_id_t) noexcept;
+        void write(msg_id_t, std::uint32_t) noexcept;
+        void write(std::string_view) noexcept;
+        void write(chrono::profiler_t const&) noexcept;
+        void write_failure(msg_id_t) noexcept;
+        void write_failure(std::string_view) noexcept;
+        void show(msg_id_t, std::uint32_t, severity_t) noexcept;
+
+        [[nodiscard]] record_writer_t make_record(record_t) noexcept;
+        void commit(record_writer_t&) noexcept;
+        [[nodiscard]] bool append(record_writer_t&) noexcept;
+        [[nodiscard]] bool value_changed(value_msg_t const&) noexcept;
+        void write_out(std::size_t) noexcept;
+        [[nodiscard]] std::size_t to_sector_boundary() const noexcept;
+        void rotate() noexcept;
+        void open_next() noexcept;
+        void preallocate() noexcept;
+
         display_t &display_;
+        chrono::monotonic_clock_t &clock_;
+        std::string_view base_;
+        log_rotation_t rotation_;
+
+        // Write side: the segment file the ring is drained into.
         File file_;
+        uint32_t file_offset_;
+        uint32_t segment_end_;
+        uint32_t segment_;          /**< Sequence number of the segment being written. */
+        uint8_t segment_index_;
+        bool growing_;              /**< The segment was not preallocated, it grows as it is written. */
+
+        // The next segment, zero filled a sector at a time while the logger is idle.
+        File next_;
+        uint32_t next_size_;
+        uint32_t prealloc_offset_;
+        uint8_t next_index_;
+
+        // Append side: where the next record formatted into the ring will land, which runs ahead of the write side.
+        uint32_t append_offset_;
+        uint32_t append_end_;
+        uint32_t append_segment_;
+        uint8_t sequence_;          /**< Sequence number of the next record. */
+        bool urgent_;               /**< A fault is buffered, write it out and flush without waiting. */
+        bool sync_;                 /**< Stale records were written out, flush the file on the next update. */
+
+        log_ring_t ring_;
+        std::optional<chrono::time_point_t> oldest_;   /**< When the oldest record in the ring was committed. */
+        level_t level_;
+
+        bool session_;
+        int64_t last_record_ms_;
+        int64_t pending_record_ms_;
+        etl::vector<logged_value_t, max_logged_values> values_;
+        repeat_filter_t repeats_;
     };
 
-    template <class T>
-    void logger_t::log_on_error(tl::expected<T,modbus_error_t> const &exp) noexcept
+    template <level_t L>
+    bool logger_t::enabled() const noexcept
+    {
+        return log_enabled<L> && (L >= level_);
+    }
+
+    template <level_t L, class T>
+    void logger_t::log_on_error(tl::expected<T,modbus_error_t> const &exp, log_site_t site) noexcept
     {
         if (!exp)
-            log(exp.error());
+            log<L>(exp.error(), site);
+    }
+
+    template <level_t L>
+    void logger_t::log_on_failure(bool passed, msg_id_t msg) noexcept
+    {
+        if (passed)
+            return;
+
+        display_.set(message_text(msg), display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write_failure(msg);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log_on_failure(bool passed, std::string_view msg) noexcept
+    {
+        if (passed)
+            return;
+
+        display_.set(msg, display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write_failure(msg);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(modbus_error_t err, log_site_t site) noexcept
+    {
+        display_.set(err, display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(err, site);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(value_msg_t vm) noexcept
+    {
+        display_.set(vm);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(vm);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(msg_id_t msg) noexcept
+    {
+        if constexpr (log_displayed<L>)
+            display_.set(message_text(msg), display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(msg);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(msg_id_t msg, std::uint32_t value) noexcept
+    {
+        if constexpr (log_displayed<L>)
+            show(msg, value, display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(msg, value);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(std::string_view msg) noexcept
+    {
+        if constexpr (log_displayed<L>)
+            display_.set(msg, display_severity<L>);
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(msg);
+        }
+    }
+
+    template <level_t L>
+    void logger_t::log(chrono::profiler_t const &profiler) noexcept
+    {
+        if constexpr (log_enabled<L>)
+        {
+            if (enabled<L>())
+                write(profiler);
+        }
     }
 
 
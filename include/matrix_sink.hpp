@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MATRIX_SINK_HPP_
+#define MATRIX_SINK_HPP_
+
+#include <cstdint>
+
+#include "frame_cache.hpp"
+#include "monotonic_clock.hpp"
+
+#if defined(ARDUINO)
+// NOTE: PlatformIO's copy of standard Arduino libraries for this platform were stale:
+// "%UserProfile%\.platformio\packages\framework-arduinorenesas-uno\libraries\Arduino_LED_Matrix"
+// so I overwrote it with the one copied from where Arduino IDE installed it at:
+// "%UserProfile%\AppData\Local\Arduino15\packages\arduino\hardware\renesas_uno\1.3.1\libraries\Arduino_LED_Matrix"
+// You may also need to do the same if there are missing method calls of your Arduino_LED_Matrix object.
+#include "Arduino_LED_Matrix.h"
+#else
+#include <array>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+#endif
+
+namespace io
+{
+    using sequence_done_t = void(*)();
+
+    /**
+    * Where display_t's frames go: the UNO R4's LED matrix on the device.  Host builds capture every frame instead,
+    * stamped with the time it would become visible, for tools that exercise the display off the device.
+    */
+    class matrix_sink_t
+    {
+    public:
+        bool begin() noexcept;
+
+        void show(uint32_t const*) noexcept;
+        void play(frame_t const*, uint32_t, sequence_done_t) noexcept;
+
+#if !defined(ARDUINO)
+        struct captured_t
+        {
+            std::array<uint32_t, 3> pixels;
+            chrono::time_point_t visible;   /**< When the frame would appear. */
+            uint32_t duration_ms;           /**< 0 for a still frame, shown until the next one. */
+        };
+
+        void set_time(chrono::time_point_t now) noexcept            { now_ = now; }
+        void complete() noexcept;
+
+        [[nodiscard]] std::vector<captured_t> const& frames() const noexcept  { return frames_; }
+        void clear() noexcept                                                { frames_.clear(); }
+
+    private:
+        chrono::time_point_t now_{};
+        sequence_done_t done_ = nullptr;
+        std::vector<captured_t> frames_;
+#else
+    private:
+        ArduinoLEDMatrix matrix_;
+#endif
+    };
+
+#if !defined(ARDUINO)
+    [[nodiscard]] bool pixel(uint32_t const*, int, int) noexcept;
+
+    /**
+    * One block per frame: a "frame <index> <duration ms>" line then eight rows of '#' (lit) and '.' (dark).
+    */
+    void write_ascii(std::ostream&, std::vector<matrix_sink_t::captured_t> const&);
+
+    /**
+    * A film strip of the frames as a plain (P2) greymap, one above the other with a grey row between each.
+    */
+    void write_pgm(std::ostream&, std::vector<matrix_sink_t::captured_t> const&);
+
+    /**
+    * Compares captured frames against a golden sequence in write_ascii()'s format, returning the index of the first
+    * frame that differs (or is missing from either side), or nothing when they match.
+    */
+    [[nodiscard]] std::optional<std::size_t> compare_ascii(std::istream&, std::vector<matrix_sink_t::captured_t> const&);
+#endif
+}
+
+#endif // MATRIX_SINK_HPP_
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MESSAGE_QUEUE_HPP_
+#define MESSAGE_QUEUE_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <etl/string.h>
+#include <etl/vector.h>
+
+#include "log_format.hpp"
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+
+namespace io
+{
+    struct value_msg_t
+    {
+        msg_id_t msg;
+        register_t id;
+        uint64_t value;
+    };
+
+    enum class severity_t : uint8_t
+    {
+        reading,
+        warning,
+        fault,
+        count
+    };
+
+    constexpr std::size_t num_severities = static_cast<std::size_t>(severity_t::count);
+
+    /**
+    * Scrolled text, lead-in included.  Long enough for the longest configuration violation,
+    * "pressure_calibration.points[7].value: missing".
+    */
+    constexpr std::size_t max_display_text = 48u;
+    using display_text_t = etl::string<max_display_text>;
+
+    /**
+    * A message waiting for the display: a modbus error, a reading or a failure text.  The text is copied in, so
+    * whoever queued it is free to reuse its buffer at once.
+    */
+    struct display_msg_t
+    {
+        enum class kind_t : uint8_t
+        {
+            error,
+            value,
+            text
+        };
+
+        kind_t kind;
+        severity_t severity;
+        modbus_error_t error = modbus_error_t::success;
+        value_msg_t value{};
+        display_text_t text;
+
+        /**
+        * Messages with the same key replace each other in the queue: a newer reading of the same register, the same
+        * error or the same text again.
+        */
+        [[nodiscard]] bool same_key(display_msg_t const&) const noexcept;
+    };
+
+    constexpr std::size_t message_queue_capacity = 16u;
+
+    /**
+    * A waiting message gains one priority step for every message_age_step it has waited, up to
+    * message_age_steps, which is exactly one severity: a reading can catch up with a fresh warning but never
+    * with a fresh fault.  Readings that wait longer than reading_ttl are stale and dropped.
+    */
+    constexpr chrono::duration_t message_age_step = std::chrono::seconds(5u);
+    constexpr uint32_t message_age_steps = 4u;
+    constexpr chrono::duration_t reading_ttl = std::chrono::seconds(30u);
+
+    struct message_latency_t
+    {
+        uint32_t shown = 0u;
+        uint32_t max_ms = 0u;
+        uint64_t total_ms = 0u;
+
+        [[nodiscard]] uint32_t mean_ms() const noexcept { return shown == 0u ? 0u : static_cast<uint32_t>(total_ms / shown); }
+    };
+
+    struct message_queue_stats_t
+    {
+        uint32_t queued = 0u;
+        uint32_t coalesced = 0u;    /**< Replaced a waiting message with the same key. */
+        uint32_t expired = 0u;      /**< Stale readings dropped unseen. */
+        uint32_t dropped = 0u;      /**< Lost to a full queue of messages that ranked higher. */
+        std::array<message_latency_t, num_severities> latency{};  /**< Time from queued to shown, by severity. */
+    };
+
+    /**
+    * Fixed capacity priority queue of display messages.  Priorities change as messages age, so rather than keep a
+    * heap the (at most 16) entries are scanned when the next message is taken.  When full, a new message displaces
+    * the lowest ranked waiting one if it outranks it, and is dropped otherwise.
+    */
+    class message_queue_t
+    {
+    public:
+        void push(display_msg_t, chrono::time_point_t) noexcept;
+        [[nodiscard]] std::optional<display_msg_t> pop(chrono::time_point_t) noexcept;
+
+        [[nodiscard]] bool empty() const noexcept                           { return entries_.empty(); }
+        [[nodiscard]] message_queue_stats_t const& stats() const noexcept   { return stats_; }
+
+    private:
+        struct entry_t
+        {
+            display_msg_t msg;
+            chrono::time_point_t queued;
+            chrono::time_point_t updated;   /**< Last coalesced into, which is what staleness is measured from. */
+        };
+
+        using entries_t = etl::vector<entry_t, message_queue_capacity>;
+
+        [[nodiscard]] static chrono::duration_t age(entry_t const&, chrono::time_point_t) noexcept;
+        [[nodiscard]] static uint32_t rank(entry_t const&, chrono::time_point_t) noexcept;
+        [[nodiscard]] static bool before(entry_t const&, entry_t const&, chrono::time_point_t) noexcept;
+        void expire(chrono::time_point_t) noexcept;
+
+        entries_t entries_;
+        message_queue_stats_t stats_;
+    };
+}
+
+#endif // MESSAGE_QUEUE_HPP_
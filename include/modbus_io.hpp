@@ -28,6 +28,9 @@
 
 #include <ModbusMaster.h>
 
+#include "monotonic_clock.hpp"
+#include "profiler.hpp"
+
 namespace io
 {
     enum class modbus_error_t
@@ -65,8 +68,10 @@ namespace io
     {
         uint8_t id = 0u;
         Stream &serial;
+        uint16_t turnaround_ms = 20u;
         optional_pint_t data_enable;
         optional_pint_t receiver_enable;
+        chrono::profiler_t *profiler = nullptr;    /**< Times each transaction when built with PUMP_PROFILING. */
     };
 
     struct register_t
@@ -81,11 +86,13 @@ namespace io
 
         void connect(connection_args_t) noexcept;
         [[nodiscard]] constexpr modbus_connection_t connection_status() const noexcept  { return connection_status_; }
-        [[nodiscard]] expected_value_t read_holding_register(register_t);
+        [[nodiscard]] expected_value_t read_holding_register(register_t) noexcept;
         [[nodiscard]] expected_void_t write_register(register_t,uint16_t) noexcept;
         void reset() noexcept;
 
      private:
+        void wait_turnaround() noexcept;
+        void end_transaction(int64_t) noexcept;
         void pre_transmission() noexcept;
         void post_transmission() noexcept;
 
@@ -93,6 +100,10 @@ namespace io
         ModbusMaster *modbus_;
         alignas(alignof(ModbusMaster)) char buffer_[sizeof(ModbusMaster)];
         modbus_connection_t connection_status_;
+        chrono::high_resolution_clock_t clock_;
+        chrono::profiler_t *profiler_;
+        int64_t turnaround_us_;
+        int64_t last_transaction_us_;
         optional_pint_t data_enable;
         optional_pint_t receiver_enable;
     };
@@ -21,6 +21,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <limits>
 
 namespace chrono
 {
@@ -39,19 +40,101 @@ namespace chrono
 
     using timer_callback_t = void (*)(time_point_t);
 
+    /**
+    * Ticks elapsed between two readings of a free running 32-bit counter, allowing for the counter to have wrapped
+    * around once in between.
+    */
+    constexpr int64_t elapsed_ticks(uint32_t last, uint32_t current) noexcept
+    {
+        if (current < last)
+        {
+            int64_t const remainder = (std::numeric_limits<uint32_t>::max() - last);
+            return remainder + int64_t{ 1 } + static_cast<int64_t>(current);
+        }
+        else
+        {
+            return static_cast<int64_t>(current - last);
+        }
+    }
+
+    /**
+    * Source of a free running 32-bit count that wraps around, such as Arduino's millis() or micros().
+    */
+    using millis_source_t = uint32_t (*)() noexcept;
+    using micros_source_t = uint32_t (*)() noexcept;
+
+#if defined(ARDUINO)
+    uint32_t hardware_millis() noexcept;
+    uint32_t hardware_micros() noexcept;
+#endif
+    uint32_t steady_millis() noexcept;
+    uint32_t steady_micros() noexcept;
+
+    /**
+    * Virtual time source that only moves when advanced, so a simulation harness can run the controller faster than
+    * real time.  Advance in steps shorter than the wrap of the 32-bit count being read (~49 days for millis, ~71
+    * minutes for micros).
+    */
+    class virtual_clock_t
+    {
+    public:
+        static uint32_t millis() noexcept;
+        static uint32_t micros() noexcept;
+        static void advance(duration_t) noexcept;
+
+    private:
+        static uint64_t micros_;
+    };
+
+#if defined(ARDUINO)
+    constexpr millis_source_t default_millis_source = hardware_millis;
+    constexpr micros_source_t default_micros_source = hardware_micros;
+#else
+    constexpr millis_source_t default_millis_source = steady_millis;
+    constexpr micros_source_t default_micros_source = steady_micros;
+#endif
+
+    /**
+    * Milliseconds since start_time, which is when now() is first called.  The source is not read until then, so a
+    * clock at namespace scope can be constructed before the hardware timers are running.
+    */
     class monotonic_clock_t
     {
     public:
-        monotonic_clock_t() noexcept;
+        explicit monotonic_clock_t(millis_source_t = default_millis_source) noexcept;
         time_point_t now() noexcept;
         
     private:
        void update() noexcept;
 
+        millis_source_t source_;
         uint32_t last_millis_;
+        bool sampled_;              /**< Whether last_millis_ holds a reading yet. */
         monotonic_time_t time_;
     };
 
+    /**
+    * Companion to monotonic_clock_t with microsecond resolution, for timing modbus transactions and profiled
+    * scopes.  The 32-bit micros() count wraps every ~71 minutes, so now() must be called at least that often: the
+    * modbus driver reads its clock on every transaction, four times a second, and the profiler on every loop.
+    * Starts at the same epoch as monotonic_clock_t, on the first call to now() or micros().
+    */
+    class high_resolution_clock_t
+    {
+    public:
+        explicit high_resolution_clock_t(micros_source_t = default_micros_source) noexcept;
+        time_point_t now() noexcept;
+        int64_t micros() noexcept;
+
+    private:
+        void update() noexcept;
+
+        micros_source_t source_;
+        uint32_t last_micros_;
+        bool sampled_;              /**< Whether last_micros_ holds a reading yet. */
+        int64_t micros_;
+    };
+
 
 
 
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NUMBER_FORMAT_HPP_
+#define NUMBER_FORMAT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// NOTE: Kept free of Arduino dependencies so host side tools can share it.
+
+namespace io
+{
+    /**
+    * Longest output of format_fixed(): sign, the 20 digits of a 64 bit value and the decimal point.
+    */
+    constexpr std::size_t max_number_chars = 22u;
+
+    namespace detail
+    {
+        constexpr char digit_pairs[] =
+            "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+            "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+        constexpr std::array<uint64_t, 20> powers_of_ten
+        {
+            1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u,
+            10000000000u, 100000000000u, 1000000000000u, 10000000000000u, 100000000000000u, 1000000000000000u,
+            10000000000000000u, 100000000000000000u, 1000000000000000000u, 10000000000000000000u
+        };
+
+        constexpr std::size_t decimal_digits(uint64_t value) noexcept
+        {
+            std::size_t n = 1u;
+            while (n != powers_of_ten.size() && value >= powers_of_ten[n])
+                ++n;
+            return n;
+        }
+
+        /**
+        * Writes exactly 'digits' digits of 'value' ending at 'end', two at a time, zero padded on the left.
+        */
+        constexpr void write_digits(char *end, uint64_t value, std::size_t digits) noexcept
+        {
+            for (; digits >= 2u; digits -= 2u)
+            {
+                std::size_t const pair = static_cast<std::size_t>(value % 100u) * 2u;
+                value /= 100u;
+                *--end = digit_pairs[pair + 1u];
+                *--end = digit_pairs[pair];
+            }
+            if (digits != 0u)
+                *--end = static_cast<char>('0' + value % 10u);
+        }
+
+        template <class T>
+        constexpr uint64_t magnitude(T value) noexcept
+        {
+            if constexpr (std::is_signed_v<T>)
+                return value < 0 ? ~static_cast<uint64_t>(value) + 1u : static_cast<uint64_t>(value);
+            else
+                return static_cast<uint64_t>(value);
+        }
+    }
+
+    /**
+    * Writes 'value' in decimal to [first, last) without a terminator, in the manner of std::to_chars: returns the
+    * end of the digits written, or nullptr when they do not fit.  The digit count is found by comparison, so the
+    * digits are written in a single pass straight into place.
+    */
+    template <class T>
+    constexpr char* format_decimal(char *first, char *last, T value) noexcept
+    {
+        static_assert(std::is_integral_v<T>, "format_decimal takes integers");
+        uint64_t const m = detail::magnitude(value);
+        bool const negative = std::is_signed_v<T> && value < 0;
+        std::size_t const digits = detail::decimal_digits(m);
+        if (static_cast<std::size_t>(last - first) < digits + (negative ? 1u : 0u))
+            return nullptr;
+
+        if (negative)
+            *first++ = '-';
+        char *end = first + digits;
+        detail::write_digits(end, m, digits);
+        return end;
+    }
+
+    /**
+    * Writes a fixed point 'value' counted in units of 10^-decimals, e.g. 812 with 1 decimal as "81.2" and -5 with 2
+    * as "-0.05".  Returns the end of what was written, or nullptr when it does not fit.
+    */
+    template <class T>
+    constexpr char* format_fixed(char *first, char *last, T value, uint8_t decimals) noexcept
+    {
+        static_assert(std::is_integral_v<T>, "format_fixed takes integers");
+        if (decimals == 0u)
+            return format_decimal(first, last, value);
+        if (decimals >= detail::powers_of_ten.size())
+            return nullptr;
+
+        uint64_t const m = detail::magnitude(value);
+        bool const negative = std::is_signed_v<T> && value < 0;
+        uint64_t const whole = m / detail::powers_of_ten[decimals];
+        std::size_t const whole_digits = detail::decimal_digits(whole);
+        std::size_t const size = (negative ? 1u : 0u) + whole_digits + 1u + decimals;
+        if (static_cast<std::size_t>(last - first) < size)
+            return nullptr;
+
+        if (negative)
+            *first++ = '-';
+        detail::write_digits(first + whole_digits, whole, whole_digits);
+        first[whole_digits] = '.';
+        char *end = first + whole_digits + 1u + decimals;
+        detail::write_digits(end, m % detail::powers_of_ten[decimals], decimals);
+        return end;
+    }
+
+    /**
+    * Builds a line of text in a caller provided buffer (of at least one char), always leaving it null terminated.
+    * Anything that does not fit is dropped, and a number is written whole or not at all.
+    */
+    class text_writer_t
+    {
+    public:
+        constexpr text_writer_t(char *buffer, std::size_t size) noexcept
+        : first_(buffer), next_(buffer), last_(buffer + size - 1u)
+        {
+            *next_ = '\0';
+        }
+
+        constexpr text_writer_t& append(std::string_view text) noexcept
+        {
+            for (std::size_t i = 0u; i != text.size() && next_ != last_; ++i)
+                *next_++ = text[i];
+            return terminate();
+        }
+
+        template <class T, class = std::enable_if_t<std::is_integral_v<T>>>
+        constexpr text_writer_t& append(T value) noexcept
+        {
+            if (char *end = format_decimal(next_, last_, value))
+                next_ = end;
+            return terminate();
+        }
+
+        template <class T>
+        constexpr text_writer_t& append_fixed(T value, uint8_t decimals) noexcept
+        {
+            if (char *end = format_fixed(next_, last_, value, decimals))
+                next_ = end;
+            return terminate();
+        }
+
+        constexpr void clear() noexcept
+        {
+            next_ = first_;
+            terminate();
+        }
+
+        [[nodiscard]] constexpr char const* c_str() const noexcept       { return first_; }
+        [[nodiscard]] constexpr std::size_t size() const noexcept        { return static_cast<std::size_t>(next_ - first_); }
+        [[nodiscard]] constexpr std::string_view view() const noexcept   { return std::string_view{ first_, size() }; }
+
+    private:
+        constexpr text_writer_t& terminate() noexcept
+        {
+            *next_ = '\0';
+            return *this;
+        }
+
+        char *first_;
+        char *next_;
+        char *last_;
+    };
+}
+
+#endif // NUMBER_FORMAT_HPP_
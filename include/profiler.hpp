@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <ostream>
+#endif
+
+namespace chrono
+{
+    /**
+    * Named scopes that can be timed by the profiler.  Add new scopes before 'count'.
+    */
+    enum class scope_t : uint8_t
+    {
+        loop,
+        process_events,
+        display_update,
+        logger_update,
+        config_watch,
+        modbus,
+        recorder_update,
+        count
+    };
+
+    constexpr std::size_t num_scopes = static_cast<std::size_t>(scope_t::count);
+
+    /**
+    * Histogram buckets are powers of two of 64 microseconds: [0,64us), [64us,128us) ... [65.5ms, inf).
+    */
+    constexpr std::size_t histogram_buckets = 12u;
+    constexpr uint32_t histogram_base_shift = 6u;
+
+    constexpr std::string_view scope_name(scope_t scope) noexcept
+    {
+        switch (scope)
+        {
+            case scope_t::loop: return "loop";
+            case scope_t::process_events: return "process_events";
+            case scope_t::display_update: return "display_update";
+            case scope_t::logger_update: return "logger_update";
+            case scope_t::config_watch: return "config_watch";
+            case scope_t::modbus: return "modbus";
+            case scope_t::recorder_update: return "recorder_update";
+            default: return "";
+        }
+    }
+
+    constexpr std::size_t histogram_bucket(uint32_t micros) noexcept
+    {
+        std::size_t bucket = 0u;
+        for (uint32_t v = micros >> histogram_base_shift; v != 0u && bucket != histogram_buckets - 1u; v >>= 1u)
+            ++bucket;
+        return bucket;
+    }
+
+    struct scope_stats_t
+    {
+        uint32_t count = 0u;
+        uint32_t min = std::numeric_limits<uint32_t>::max();
+        uint32_t max = 0u;
+        uint64_t total = 0u;
+        std::array<uint32_t, histogram_buckets> histogram{};
+
+        [[nodiscard]] uint32_t mean() const noexcept { return count == 0u ? 0u : static_cast<uint32_t>(total / count); }
+    };
+
+    /**
+    * Microseconds since the monotonic epoch, read from a high_resolution_clock_t so scope timings never see the
+    * 32-bit micros() count wrap.
+    */
+    int64_t profiler_micros() noexcept;
+
+    /**
+    * Elapsed microseconds as recorded by the profiler, saturating rather than wrapping.
+    */
+    constexpr uint32_t to_profile_micros(int64_t micros) noexcept
+    {
+        if (micros < 0)
+            return 0u;
+        return micros > std::numeric_limits<uint32_t>::max() ? std::numeric_limits<uint32_t>::max() :
+            static_cast<uint32_t>(micros);
+    }
+
+    /**
+    * Accumulates per scope execution time statistics and the number of main loop iterations that blew their budget.
+    */
+    class profiler_t
+    {
+    public:
+        profiler_t() noexcept;
+
+        void record(scope_t, uint32_t) noexcept;
+        void record_overrun() noexcept;
+        void reset() noexcept;
+
+        [[nodiscard]] scope_stats_t const& stats(scope_t scope) const noexcept  { return stats_[static_cast<std::size_t>(scope)]; }
+        [[nodiscard]] uint32_t overruns() const noexcept                        { return overruns_; }
+
+#if defined(ARDUINO)
+        void dump(Print&) const noexcept;
+#else
+        void dump(std::ostream&) const;
+#endif
+
+    private:
+        std::size_t format(scope_t, char*, std::size_t) const noexcept;
+        std::size_t format_overruns(char*, std::size_t) const noexcept;
+
+        std::array<scope_stats_t, num_scopes> stats_;
+        uint32_t overruns_;
+    };
+
+    /**
+    * RAII timer that records the lifetime of the object against a scope.
+    */
+    class profile_scope_t
+    {
+    public:
+        profile_scope_t(profiler_t &prof, scope_t scope) noexcept
+        : profiler_(prof), scope_(scope), start_(profiler_micros())
+        {}
+
+        ~profile_scope_t() noexcept
+        {
+            profiler_.record(scope_, to_profile_micros(profiler_micros() - start_));
+        }
+
+        profile_scope_t(profile_scope_t const&) = delete;
+        profile_scope_t& operator=(profile_scope_t const&) = delete;
+
+    private:
+        profiler_t &profiler_;
+        scope_t scope_;
+        int64_t start_;
+    };
+}
+
+// Instrumentation is only compiled in when building with -D PUMP_PROFILING, otherwise the sites vanish.
+#if defined(PUMP_PROFILING)
+#define PROFILE_CONCAT_IMPL(a, b) a ## b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(profiler, scope) chrono::profile_scope_t PROFILE_CONCAT(profile_scope_, __LINE__){ profiler, scope }
+#define PROFILE_OVERRUN(profiler) (profiler).record_overrun()
+#else
+#define PROFILE_SCOPE(profiler, scope) ((void)0)
+#define PROFILE_OVERRUN(profiler) ((void)0)
+#endif
+
+#endif // PROFILER_HPP_
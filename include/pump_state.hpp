@@ -24,6 +24,7 @@
 #include <optional>
 #include <variant>
 
+#include "calibration.hpp"
 #include "event_queue.hpp"
 #include "logging.hpp"
 #include "modbus_io.hpp"
@@ -94,7 +95,8 @@ namespace control
     /**
     * Arguments used to initialize the pump controller.  The flood register is optional.  If supplied is means you have a liquid sensor hooked
     * up that when triggered by coming into contact with a liquid will trigger a low state below the specified value, that will indicate
-    * a flood condition in which the pump shall be stopped for the specified timeout duration.
+    * a flood condition in which the pump shall be stopped for the specified timeout duration.  The calibrations turn
+    * raw input values into the units the stepper levels and flood trigger value are given in.
     */
     struct args_t
     {
@@ -109,19 +111,61 @@ namespace control
 
         uint16_t flood_trigger_value;
         chrono::duration_t flood_timeout;
+
+        io::calibration_t pressure_calibration;
+        io::calibration_t flood_calibration;
+    };
+
+    /**
+    * Stepper levels only make sense when the pump starts below the fill pressure and the fill pressure is below the
+    * stop pressure.
+    */
+    constexpr bool valid_levels(stepper_levels_t const &levels) noexcept
+    {
+        return levels.start.pressure < levels.fill.pressure && levels.fill.pressure < levels.stop.pressure;
+    }
+
+    /**
+    * Valid levels and calibrations, and run and stop patterns that differ so the pump's state can be told apart.
+    */
+    constexpr bool valid_args(args_t const &args) noexcept
+    {
+        return valid_levels(args.levels) && args.run_args.run != args.run_args.stop &&
+            io::valid_calibration(args.pressure_calibration) && io::valid_calibration(args.flood_calibration);
+    }
+
+    /**
+    * Snapshot of the pump's input and desired output state at the end of an update.
+    */
+    struct sample_t
+    {
+        chrono::time_point_t time;
+        std::optional<uint16_t> pressure;  /**< Calibrated. */
+        uint16_t run = 0u;
+        uint16_t frequency = 0u;
+        bool running = false;
+        bool flooded = false;
+        uint16_t faults = 0u;   /**< Failed modbus transactions during the update. */
     };
 
+    using sample_handler_t = void (*)(sample_t const&);
+
     class pump_t
     {
     public:
         pump_t(io::logger_t&, chrono::monotonic_clock_t&, chrono::event_queue_t&) noexcept;
         void begin(args_t) noexcept;
+        [[nodiscard]] bool reconfigure(args_t) noexcept;
         void update() noexcept;
+        void on_sample(sample_handler_t) noexcept;
 
     private:
         using optional_value_t = std::optional<uint16_t>;
 
-        [[nodiscard]] optional_value_t read_input(io::input_source_t) const noexcept;
+        template <class T>
+        void log_on_error(tl::expected<T,io::modbus_error_t> const&, io::log_site_t = io::log_site_t::current()) noexcept;
+
+        [[nodiscard]] optional_value_t read_input(io::input_source_t, io::calibration_table_t const&) noexcept;
         [[nodiscard]] io::expected_void_t push_state(state_item_t const&, bool = false) const noexcept;
         [[nodiscard]] io::expected_void_t pull_state(state_item_t&) noexcept;
         [[nodiscard]] bool is_running() noexcept;
@@ -133,17 +177,32 @@ namespace control
         void update_frequency(uint16_t) noexcept;
         void update_flood(uint16_t) noexcept;
         void full_stop() noexcept;
+        void apply_pending_args() noexcept;
+        void build_calibrations() noexcept;
 
         io::logger_t &logger_;
         chrono::monotonic_clock_t &time_;
         chrono::event_queue_t &events_;
 
         args_t args_;
+        std::optional<args_t> pending_args_;
         state_t state_;
+        io::calibration_table_t pressure_table_;
+        io::calibration_table_t flood_table_;
+        sample_handler_t sample_handler_;
 
         uint16_t failed_pressure_;
+        uint16_t faults_;
         bool flooded_;
     };
+
+    template <class T>
+    void pump_t::log_on_error(tl::expected<T,io::modbus_error_t> const &exp, io::log_site_t site) noexcept
+    {
+        if (!exp)
+            ++faults_;
+        logger_.log_on_error(exp, site);
+    }
 }
 
 #endif // PUMP_STATE_HPP_
\ No newline at end of file
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REPEAT_FILTER_HPP_
+#define REPEAT_FILTER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+
+namespace io
+{
+    /**
+    * Source location of a log call, captured through default arguments at the call site.
+    */
+    struct log_site_t
+    {
+        char const *file = "";
+        uint16_t line = 0u;
+
+        static constexpr log_site_t current(char const *file = __builtin_FILE(), uint16_t line = __builtin_LINE()) noexcept
+        {
+            return log_site_t{ file, line };
+        }
+    };
+
+    struct repeat_summary_t
+    {
+        modbus_error_t error;
+        log_site_t site;
+        uint32_t count;         /**< Occurrences suppressed after the first. */
+        int64_t duration_ms;    /**< From the first occurrence to the last suppressed one. */
+    };
+
+    constexpr std::size_t repeat_filter_slots = 16u;
+    constexpr chrono::duration_t default_repeat_window = std::chrono::seconds(60u);
+
+    /**
+    * Collapses repeats of the same modbus error from the same log site.  The first occurrence in a window is let
+    * through, later ones are only counted, and once the window closes the count is handed back as a summary.  Keys
+    * live in a small open addressed hash table; when it is full the oldest entry is summarized and evicted.
+    */
+    class repeat_filter_t
+    {
+    public:
+        repeat_filter_t() noexcept;
+
+        void set_window(chrono::duration_t) noexcept;
+
+        template <class Emit>
+        [[nodiscard]] bool pass(modbus_error_t, log_site_t, int64_t, Emit&&) noexcept;
+
+        template <class Emit>
+        void expire(int64_t, Emit&&) noexcept;
+
+    private:
+        struct entry_t
+        {
+            uint32_t key = 0u;  /**< Zero marks an empty slot. */
+            modbus_error_t error = modbus_error_t::success;
+            log_site_t site;
+            int64_t first_ms = 0;
+            int64_t last_ms = 0;
+            uint32_t count = 0u;
+        };
+
+        [[nodiscard]] static uint32_t make_key(modbus_error_t, log_site_t) noexcept;
+        [[nodiscard]] static bool matches(entry_t const&, uint32_t, modbus_error_t, log_site_t) noexcept;
+        [[nodiscard]] static repeat_summary_t summarize(entry_t const&) noexcept;
+
+        std::array<entry_t, repeat_filter_slots> entries_;
+        int64_t window_ms_;
+    };
+
+    template <class Emit>
+    bool repeat_filter_t::pass(modbus_error_t error, log_site_t site, int64_t now_ms, Emit &&emit) noexcept
+    {
+        uint32_t const key = make_key(error, site);
+        std::size_t const start = key % entries_.size();
+        entry_t *empty = nullptr;
+        entry_t *oldest = nullptr;
+
+        // Probe the whole table: slots freed by expire() can sit in front of a live key.
+        for (std::size_t i = 0; i != entries_.size(); ++i)
+        {
+            entry_t &entry = entries_[(start + i) % entries_.size()];
+            if (matches(entry, key, error, site))
+            {
+                if ((now_ms - entry.first_ms) < window_ms_)
+                {
+                    ++entry.count;
+                    entry.last_ms = now_ms;
+                    return false;
+                }
+
+                if (entry.count != 0u)
+                    emit(summarize(entry));
+                entry.first_ms = now_ms;
+                entry.last_ms = now_ms;
+                entry.count = 0u;
+                return true;
+            }
+
+            if (entry.key == 0u)
+            {
+                if (empty == nullptr)
+                    empty = &entry;
+            }
+            else if (oldest == nullptr || entry.first_ms < oldest->first_ms)
+            {
+                oldest = &entry;
+            }
+        }
+
+        entry_t *slot = empty;
+        if (slot == nullptr)
+        {
+            slot = oldest;
+            if (slot->count != 0u)
+                emit(summarize(*slot));
+        }
+
+        *slot = entry_t{ key, error, site, now_ms, now_ms, 0u };
+        return true;
+    }
+
+    template <class Emit>
+    void repeat_filter_t::expire(int64_t now_ms, Emit &&emit) noexcept
+    {
+        for (entry_t &entry : entries_)
+        {
+            if (entry.key == 0u || (now_ms - entry.first_ms) < window_ms_)
+                continue;
+
+            if (entry.count != 0u)
+                emit(summarize(entry));
+            entry = entry_t{};
+        }
+    }
+}
+
+#endif // REPEAT_FILTER_HPP_
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RUNTIME_COUNTERS_HPP_
+#define RUNTIME_COUNTERS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "counter_store.hpp"
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+
+namespace control
+{
+    /**
+    * Counters are committed to flash at most this often, and only when they changed.  At 64 bytes a commit this
+    * wears each data flash block once every ~32 hours, and a power loss costs at most this much run time.
+    */
+    constexpr chrono::duration_t counter_commit_interval = std::chrono::minutes(15u);
+
+    /**
+    * Accumulates lifetime pump statistics (starts, run time, run time per frequency, flood trips and modbus faults)
+    * from the pump's samples and persists them through the counter store.
+    */
+    class runtime_counters_t
+    {
+    public:
+        explicit runtime_counters_t(io::counter_store_t&) noexcept;
+
+        void begin() noexcept;
+        void record(sample_t const&) noexcept;
+
+        [[nodiscard]] io::pump_counters_t const& counters() const noexcept    { return counters_; }
+
+    private:
+        void add_run_time(uint16_t, uint32_t) noexcept;
+
+        io::counter_store_t &store_;
+        io::pump_counters_t counters_;
+        std::optional<sample_t> last_;
+        std::optional<chrono::time_point_t> last_commit_;
+        uint32_t run_ms_;   /**< Run time not yet added up to a whole second. */
+        std::array<uint32_t, io::counted_frequencies> frequency_ms_;
+        bool dirty_;
+    };
+}
+
+#endif // RUNTIME_COUNTERS_HPP_
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCROLL_CANVAS_HPP_
+#define SCROLL_CANVAS_HPP_
+
+#include <cstdint>
+
+#include "ArduinoGraphics.h"
+#include "frame_cache.hpp"
+
+namespace io
+{
+    /**
+    * Off screen 12x8 canvas that renders scrolling text into LED matrix animation frames.  Pixels are kept packed
+    * one bit each, exactly as a frame holds them, so glyphs are blitted a row at a time and every frame drawn is
+    * simply copied out with its duration.  Still images drawn between beginDraw() and endDraw() are left in
+    * pixels(), ready for ArduinoLEDMatrix::loadFrame().
+    */
+    class scroll_canvas_t : public ArduinoGraphics
+    {
+    public:
+        scroll_canvas_t() noexcept;
+
+        [[nodiscard]] uint32_t render(char const*, Font const&, uint32_t, frame_t*, uint32_t) noexcept;
+        [[nodiscard]] uint32_t const* pixels() const noexcept  { return pixels_; }
+
+        void beginDraw() override;
+        void endDraw() override;
+        using ArduinoGraphics::set;
+        void set(int, int, uint8_t, uint8_t, uint8_t) override;
+
+    private:
+        uint32_t pixels_[3];
+        frame_t *frames_;
+        uint32_t capacity_;
+        uint32_t used_;
+        uint32_t milliseconds_per_frame_;
+    };
+}
+
+#endif // SCROLL_CANVAS_HPP_
@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SERIES_FORMAT_HPP_
+#define SERIES_FORMAT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "encoding.hpp"
+
+// NOTE: Kept free of Arduino dependencies so the host side series decoder can share it.
+
+namespace io
+{
+    struct series_point_t
+    {
+        int64_t time_ms = 0;
+        uint16_t pressure = 0u;
+        uint16_t frequency = 0u;
+        uint16_t run = 0u;
+    };
+
+    /**
+    * The pressure/frequency history is stored in fixed size blocks, one SD sector each.  A block starts with a header
+    * holding the first point verbatim, followed by the remaining points as varint deltas from the point before:
+    * [time delta ms][zigzag pressure delta][zigzag frequency delta][zigzag run delta].  The rest of the block is zero.
+    *
+    * Header (little endian): magic:u32, sequence:u32, time_ms:i64, pressure:u16, frequency:u16, run:u16, count:u16,
+    * used:u16 (payload bytes), reserved:u16.
+    */
+    constexpr std::size_t series_block_size = 512u;
+    constexpr std::size_t series_header_size = 32u;
+    constexpr uint32_t series_magic = 0x31535450u; // "PTS1"
+
+    using series_block_data_t = std::array<uint8_t, series_block_size>;
+
+    class series_block_t
+    {
+    public:
+        constexpr series_block_t() noexcept
+        : data_{}, last_{}, sequence_(0u), count_(0u), used_(0u)
+        {}
+
+        constexpr void reset(uint32_t sequence) noexcept
+        {
+            data_ = series_block_data_t{};
+            sequence_ = sequence;
+            count_ = 0u;
+            used_ = 0u;
+        }
+
+        /**
+        * Returns false, leaving the block untouched, if the point does not fit.
+        */
+        constexpr bool append(series_point_t const &point) noexcept
+        {
+            if (count_ == 0u)
+            {
+                last_ = point;
+                count_ = 1u;
+                write_header();
+                return true;
+            }
+
+            std::array<uint8_t, 4u * max_varint_size> encoded{};
+            std::size_t size = 0u;
+            size += encode_varint(static_cast<uint64_t>(point.time_ms - last_.time_ms), encoded.data() + size, encoded.size() - size);
+            size += encode_varint(zigzag_encode(int64_t{ point.pressure } - last_.pressure), encoded.data() + size, encoded.size() - size);
+            size += encode_varint(zigzag_encode(int64_t{ point.frequency } - last_.frequency), encoded.data() + size, encoded.size() - size);
+            size += encode_varint(zigzag_encode(int64_t{ point.run } - last_.run), encoded.data() + size, encoded.size() - size);
+
+            if (series_header_size + used_ + size > series_block_size)
+                return false;
+
+            for (std::size_t i = 0u; i != size; ++i)
+                data_[series_header_size + used_ + i] = encoded[i];
+
+            used_ += static_cast<uint16_t>(size);
+            ++count_;
+            last_ = point;
+            write_header();
+            return true;
+        }
+
+        [[nodiscard]] constexpr bool empty() const noexcept                         { return count_ == 0u; }
+        [[nodiscard]] constexpr uint32_t sequence() const noexcept                  { return sequence_; }
+        [[nodiscard]] constexpr series_block_data_t const& data() const noexcept    { return data_; }
+
+    private:
+        constexpr void write_header() noexcept
+        {
+            // Only the first point and the counts change once a block is started.
+            if (count_ == 1u)
+            {
+                store_le<uint32_t>(series_magic, data_.data());
+                store_le<uint32_t>(sequence_, data_.data() + 4u);
+                store_le<int64_t>(last_.time_ms, data_.data() + 8u);
+                store_le<uint16_t>(last_.pressure, data_.data() + 16u);
+                store_le<uint16_t>(last_.frequency, data_.data() + 18u);
+                store_le<uint16_t>(last_.run, data_.data() + 20u);
+            }
+            store_le<uint16_t>(count_, data_.data() + 22u);
+            store_le<uint16_t>(used_, data_.data() + 24u);
+        }
+
+        series_block_data_t data_;
+        series_point_t last_;
+        uint32_t sequence_;
+        uint16_t count_;
+        uint16_t used_;
+    };
+
+    /**
+    * Decodes every point of a block, calling 'visit' for each.  Returns false if the block is not a valid series
+    * block, such as an unused (zeroed) block at the end of a file.
+    */
+    template <class Visitor>
+    constexpr bool decode_series_block(uint8_t const *block, Visitor &&visit) noexcept
+    {
+        if (load_le<uint32_t>(block) != series_magic)
+            return false;
+
+        uint16_t const count = load_le<uint16_t>(block + 22u);
+        uint16_t const used = load_le<uint16_t>(block + 24u);
+        if (count == 0u || series_header_size + used > series_block_size)
+            return false;
+
+        series_point_t point
+        {
+            load_le<int64_t>(block + 8u),
+            load_le<uint16_t>(block + 16u),
+            load_le<uint16_t>(block + 18u),
+            load_le<uint16_t>(block + 20u)
+        };
+        visit(point);
+
+        uint8_t const *in = block + series_header_size;
+        uint8_t const *end = in + used;
+        for (uint16_t i = 1u; i < count; ++i)
+        {
+            std::array<uint64_t, 4u> fields{};
+            for (uint64_t &field : fields)
+            {
+                std::size_t const size = decode_varint(in, static_cast<std::size_t>(end - in), field);
+                if (size == 0u)
+                    return false;
+                in += size;
+            }
+
+            point.time_ms += static_cast<int64_t>(fields[0]);
+            point.pressure = static_cast<uint16_t>(point.pressure + zigzag_decode(fields[1]));
+            point.frequency = static_cast<uint16_t>(point.frequency + zigzag_decode(fields[2]));
+            point.run = static_cast<uint16_t>(point.run + zigzag_decode(fields[3]));
+            visit(point);
+        }
+        return true;
+    }
+}
+
+#endif // SERIES_FORMAT_HPP_
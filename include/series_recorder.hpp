@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SERIES_RECORDER_HPP_
+#define SERIES_RECORDER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+#include "series_format.hpp"
+
+#include <SPI.h>
+#include <SD.h>
+
+namespace io
+{
+    constexpr char const *series_file_path = "PMPCTRL.TS";
+
+    /**
+    * Pump samples are considered at most once per interval.  A sample is only recorded if the run or frequency
+    * changed, the pressure moved by more than the deadband, or nothing has been recorded for the heartbeat duration,
+    * so long flat idle periods cost next to nothing.
+    */
+    struct recorder_args_t
+    {
+        chrono::duration_t interval = std::chrono::seconds(1u);
+        uint16_t pressure_deadband = 2u;
+        chrono::duration_t heartbeat = std::chrono::minutes(10u);
+    };
+
+    /**
+    * The block being filled is rewritten in place on this interval, bounding what a power loss can take.  Writes
+    * are made from update() in the main loop, never from the pump's sample handler.
+    */
+    constexpr chrono::duration_t series_flush_interval = std::chrono::minutes(1u);
+
+    class series_recorder_t
+    {
+    public:
+        series_recorder_t() noexcept;
+
+        void begin(std::string_view, recorder_args_t) noexcept;
+        void configure(recorder_args_t) noexcept;
+        void record(control::sample_t const&) noexcept;
+        void update(chrono::time_point_t) noexcept;
+
+    private:
+        [[nodiscard]] bool significant(series_point_t const&) const noexcept;
+        void write_block(series_block_t const&, uint32_t) noexcept;
+
+        File file_;
+        recorder_args_t args_;
+        series_block_t block_;
+        uint32_t block_offset_;
+        series_block_t full_;       /**< A filled block waiting for update() to write it out. */
+        uint32_t full_offset_;
+        bool full_pending_;
+        std::optional<series_point_t> last_recorded_;
+        std::optional<chrono::time_point_t> last_considered_;
+        chrono::time_point_t last_flush_;
+        bool dirty_;
+    };
+}
+
+#endif // SERIES_RECORDER_HPP_
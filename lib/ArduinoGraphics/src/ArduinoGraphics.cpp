@@ -27,9 +27,12 @@ ArduinoGraphics::ArduinoGraphics(int width, int height) :
   _width(width),
   _height(height),
   _font(NULL),
+  _textLength(0),
   _textSizeX(1),
-  _textSizeY(1)
+  _textSizeY(1),
+  _packed(NULL)
 {
+  _textBuffer[0] = '\0';
 }
 
 ArduinoGraphics::~ArduinoGraphics()
@@ -291,11 +294,21 @@ void ArduinoGraphics::textSize(uint8_t sx, uint8_t sy)
 }
 
 
+void ArduinoGraphics::packedFramebuffer(uint32_t* words)
+{
+  _packed = words;
+}
+
 void ArduinoGraphics::bitmap(const uint8_t* data, int x, int y, int w, int h, uint8_t scale_x, uint8_t scale_y) {
   if (!_stroke || !scale_x || !scale_y) {
     return;
   }
 
+  if (_packed && data && scale_x == 1 && scale_y == 1 && w <= 8) {
+    packedBitmap(data, x, y, w, h);
+    return;
+  }
+
   if ((data == nullptr) || ((x + (w * scale_x) < 0)) || ((y + (h * scale_y) < 0)) || (x > _width) || (y > _height)) {
     // offscreen
     return;
@@ -407,7 +420,12 @@ void ArduinoGraphics::set(int x, int y, uint32_t color)
 size_t ArduinoGraphics::write(uint8_t b)
 {
   if (b != 0xc2 && b != 0xc3) {
-    _textBuffer += (char)b;
+    if (_textLength == ARDUINOGRAPHICS_TEXT_CAPACITY) {
+      // full, truncate
+      return 0;
+    }
+    _textBuffer[_textLength++] = (char)b;
+    _textBuffer[_textLength] = '\0';
   }
 
   return 1;
@@ -415,12 +433,13 @@ size_t ArduinoGraphics::write(uint8_t b)
 
 void ArduinoGraphics::flush()
 {
-  _textBuffer = "";
+  _textLength = 0;
+  _textBuffer[0] = '\0';
 }
 
 void ArduinoGraphics::beginText(int x, int y)
 {
-  _textBuffer = "";
+  flush();
 
   _textX = x;
   _textY = y;
@@ -452,7 +471,7 @@ void ArduinoGraphics::endText(int scrollDirection)
   stroke(_textR, _textG, _textB);
 
   if (scrollDirection == SCROLL_LEFT) {
-    int scrollLength = _textBuffer.length() * textFontWidth() + _textX;
+    int scrollLength = _textLength * textFontWidth() + _textX;
 
     for (int i = 0; i < scrollLength; i++) {
       beginDraw();
@@ -464,7 +483,7 @@ void ArduinoGraphics::endText(int scrollDirection)
       delay(_textScrollSpeed);
     }
   } else if (scrollDirection == SCROLL_RIGHT) {
-    int scrollLength = _textBuffer.length() * textFontWidth() + _textX;
+    int scrollLength = _textLength * textFontWidth() + _textX;
 
     for (int i = 0; i < scrollLength; i++) {
       beginDraw();
@@ -513,7 +532,7 @@ void ArduinoGraphics::endText(int scrollDirection)
   }
 
   // clear the buffer
-  _textBuffer = "";
+  flush();
 }
 
 void ArduinoGraphics::textScrollSpeed(unsigned long speed)
@@ -521,6 +540,44 @@ void ArduinoGraphics::textScrollSpeed(unsigned long speed)
   _textScrollSpeed = speed;
 }
 
+void ArduinoGraphics::packedBitmap(const uint8_t* data, int x, int y, int w, int h)
+{
+  // clip once for the whole bitmap
+  int const left = (x < 0) ? -x : 0;
+  int const right = (x + w > _width) ? x + w - _width : 0;
+  int const top = (y < 0) ? -y : 0;
+  int const bottom = (y + h > _height) ? y + h - _height : 0;
+  int const visible = w - left - right;
+  if (visible <= 0 || top >= h - bottom) {
+    return;
+  }
+
+  // lit pixels are the set bits of each row, unlit ones the clear bits, whatever the colors
+  uint32_t const fg = (_strokeR | _strokeG | _strokeB) ? 0xFFFFFFFFu : 0u;
+  uint32_t const bg = (_backgroundR | _backgroundG | _backgroundB) ? 0xFFFFFFFFu : 0u;
+  uint32_t const mask = (1u << visible) - 1u;
+  int const shift = 8 - w + right;
+
+  uint32_t bit = (uint32_t)((y + top) * _width + x + left);
+  for (int j = top; j < h - bottom; j++, bit += _width) {
+    uint32_t const row = ((uint32_t)data[j] >> shift) & mask;
+    uint32_t const bits = (row & fg) | (~row & bg & mask);
+
+    // the row lands in at most two words, most significant bit first
+    uint32_t* const word = _packed + (bit >> 5);
+    int const offset = (int)(bit & 31u);
+    int const spill = offset + visible - 32;
+    if (spill <= 0) {
+      int const s = -spill;
+      word[0] = (word[0] & ~(mask << s)) | (bits << s);
+    } else {
+      word[0] = (word[0] & ~(mask >> spill)) | (bits >> spill);
+      int const s = 32 - spill;
+      word[1] = (word[1] & ~(mask << s)) | (bits << s);
+    }
+  }
+}
+
 void ArduinoGraphics::lineLow(int x1, int y1, int x2, int y2)
 {
   int dx = x2 - x1;
@@ -25,6 +25,12 @@
 #include "Font.h"
 #include "Image.h"
 
+// Characters kept between beginText() and endText(); anything printed beyond is dropped.  50 characters of the
+// 5x7 font, the display's longest text and its line end, scroll in 250 frames.
+#ifndef ARDUINOGRAPHICS_TEXT_CAPACITY
+#define ARDUINOGRAPHICS_TEXT_CAPACITY 50
+#endif
+
 enum {
   NO_SCROLL,
   SCROLL_LEFT,
@@ -94,6 +100,11 @@ public:
   virtual void textScrollSpeed(unsigned long speed = 150);
 
 protected:
+  // Canvases that keep a 1 bit per pixel framebuffer can attach it here: width * height bits, row major, most
+  // significant bit first within each word (the layout of the UNO R4 LED matrix frames).  Unscaled bitmaps and
+  // text are then drawn by shifting whole glyph rows into its words instead of calling set() once per pixel.
+  void packedFramebuffer(uint32_t* words);
+
   virtual void bitmap(const uint8_t* data, int x, int y, int w, int h, uint8_t scale_x = 1, 
                       uint8_t scale_y = 1);
   virtual void imageRGB(const Image& img, int x, int y, int width, int height);
@@ -101,6 +112,7 @@ protected:
   virtual void imageRGB16(const Image& img, int x, int y, int width, int height);
 
 private:
+  void packedBitmap(const uint8_t* data, int x, int y, int w, int h);
   void lineLow(int x1, int y1, int x2, int y2);
   void lineHigh(int x1, int y1, int x2, int y2);
 
@@ -114,13 +126,16 @@ private:
   uint8_t _fillR, _fillG, _fillB;
   uint8_t _strokeR, _strokeG, _strokeB;
 
-  String _textBuffer;
+  char _textBuffer[ARDUINOGRAPHICS_TEXT_CAPACITY + 1];
+  size_t _textLength;
   uint8_t _textR, _textG, _textB;
   int _textX;
   int _textY;
   uint8_t _textSizeX;
   uint8_t _textSizeY;
   unsigned long _textScrollSpeed;
+
+  uint32_t* _packed;
 };
 
 extern const struct Font Font_4x6;
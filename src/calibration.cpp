@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "calibration.hpp"
+
+namespace
+{
+    using io::calibration_point_t;
+
+    /**
+    * Value of the line through two points at a raw value given in 16.16 fixed point.
+    */
+    int64_t interpolate(calibration_point_t const &a, calibration_point_t const &b, int64_t raw) noexcept
+    {
+        int64_t const rise = static_cast<int64_t>(b.value) - a.value;
+        int64_t const run = (static_cast<int64_t>(b.raw) - a.raw) << 16;
+        return a.value + rise * (raw - (static_cast<int64_t>(a.raw) << 16)) / run;
+    }
+
+    int64_t evaluate_piecewise(io::calibration_t const &cal, int64_t raw) noexcept
+    {
+        calibration_point_t const *first = cal.points.data();
+        calibration_point_t const *last = first + cal.count - 1u;
+        if (raw <= (static_cast<int64_t>(first->raw) << 16))
+            return first->value;
+        if (raw >= (static_cast<int64_t>(last->raw) << 16))
+            return last->value;
+
+        calibration_point_t const *next = first + 1;
+        while ((static_cast<int64_t>(next->raw) << 16) < raw)
+            ++next;
+        return interpolate(*(next - 1), *next, raw);
+    }
+
+    int64_t evaluate_polynomial(io::calibration_t const &cal, int64_t raw) noexcept
+    {
+        // Horner's rule with t = raw / raw_max in 16.16 fixed point.
+        int64_t const t = raw / cal.raw_max;
+        int64_t sum = 0;
+        for (std::size_t i = cal.count; i != 0u; --i)
+            sum = ((sum * t) >> 16) + cal.coefficients[i - 1u];
+        return sum;
+    }
+
+    int64_t evaluate(io::calibration_t const &cal, int64_t raw) noexcept
+    {
+        switch (cal.kind)
+        {
+            case io::calibration_kind_t::linear: return interpolate(cal.points[0], cal.points[1], raw);
+            case io::calibration_kind_t::piecewise: return evaluate_piecewise(cal, raw);
+            case io::calibration_kind_t::polynomial: return evaluate_polynomial(cal, raw);
+            default: return raw >> 16;
+        }
+    }
+}
+
+namespace io
+{
+    calibration_table_t::calibration_table_t() noexcept
+    : table_{}, step_(0u), raw_max_(UINT16_MAX), identity_(true)
+    {}
+
+    void calibration_table_t::build(calibration_t const &cal) noexcept
+    {
+        identity_ = cal.kind == calibration_kind_t::none || !valid_calibration(cal);
+        if (identity_)
+            return;
+
+        raw_max_ = cal.raw_max;
+        step_ = static_cast<uint32_t>((steps << 16u) / raw_max_);
+
+        // Each entry is evaluated at the raw value the lookup maps onto it, so rounding in step_ does not skew the
+        // table against its input.
+        for (std::size_t i = 0u; i != steps + 1u; ++i)
+        {
+            int64_t const raw = static_cast<int64_t>((static_cast<uint64_t>(i) << 32u) / step_);
+            table_[i] = static_cast<uint16_t>(std::clamp<int64_t>(evaluate(cal, raw), 0, UINT16_MAX));
+        }
+        table_[steps + 1u] = table_[steps];
+    }
+}
@@ -17,25 +17,138 @@
  */
 
 #include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <variant>
 
 #include "config.hpp"
+#include "config_cache.hpp"
+#include "config_filter.hpp"
+#include "json_arena.hpp"
+#include "number_format.hpp"
 #include "pump_state.hpp"
 
 #include <ArduinoJson.h>
 #include <SPI.h>
 #include <SD.h>
 
-namespace io
+namespace
 {
+    alignas(std::max_align_t) uint8_t arena_buffer[io::config_arena_size];
+    io::json_arena_t arena{ arena_buffer, sizeof(arena_buffer) };
+
+    constexpr std::size_t max_violations = 8u;
+
+    /**
+    * Settings that were replaced by their defaults, as "<JSON path>: <problem>", from the parse in progress.  The
+    * display copies each text as it is queued, so they can be cleared for the next parse.
+    */
+    etl::vector<io::display_text_t, max_violations> violations;
+    uint32_t violation_count = 0u;
+
+    void report(std::string_view path, std::string_view problem) noexcept
+    {
+        ++violation_count;
+        if (violations.full())
+            return;
+
+        io::display_text_t text{ path.data(), path.size() };
+        text.append(": ");
+        text.append(problem.data(), problem.size());
+        violations.push_back(text);
+    }
+
+    io::display_text_t join(std::string_view path, std::string_view key) noexcept
+    {
+        io::display_text_t joined{ path.data(), path.size() };
+        joined.push_back('.');
+        joined.append(key.data(), key.size());
+        return joined;
+    }
+
+    std::string_view view(io::display_text_t const &text) noexcept
+    {
+        return std::string_view{ text.data(), text.size() };
+    }
+
+    bool same_input(io::optional_input_t const &lhs, io::optional_input_t const &rhs) noexcept
+    {
+        if (!lhs || !rhs)
+            return !lhs && !rhs;
+        if (auto const *reg = std::get_if<io::register_t>(&*lhs))
+            return std::holds_alternative<io::register_t>(*rhs) && std::get<io::register_t>(*rhs).address == reg->address;
+        return std::holds_alternative<io::analog_input_t>(*rhs) &&
+            std::get<io::analog_input_t>(*rhs).pin == std::get<io::analog_input_t>(*lhs).pin;
+    }
+
+    /**
+    * Checks an integer setting.  A missing optional setting is not a violation, anything else that is not an integer
+    * within [min, max] is reported and comes back empty, for the caller to fall back to its default.
+    */
+    std::optional<int64_t> check_integer(JsonVariantConst const &value, std::string_view path, int64_t min,
+        int64_t max, bool required = true) noexcept
+    {
+        if (value.isNull())
+        {
+            if (required)
+                report(path, "missing");
+            return std::nullopt;
+        }
+
+        if (!value.is<int64_t>())
+        {
+            report(path, "type");
+            return std::nullopt;
+        }
+
+        int64_t const integer = value.as<int64_t>();
+        if (integer < min || integer > max)
+        {
+            report(path, "range");
+            return std::nullopt;
+        }
+        return integer;
+    }
 
-    init_register_t read_init_register(JsonObjectConst const &obj) noexcept
+    template <class T>
+    T read_integer(JsonVariantConst const &value, std::string_view path, T fallback, int64_t min = 0,
+        int64_t max = std::numeric_limits<T>::max(), bool required = true) noexcept
     {
-        uint16_t const reg_addr = obj["reg"];
-        uint16_t const value = obj["value"];
-        return init_register_t{ register_t{ reg_addr }, value};
+        return static_cast<T>(check_integer(value, path, min, max, required).value_or(fallback));
     }
 
-    analog_input_t analog_id_to_pin(std::string_view id) noexcept
+    template <class T>
+    T read_optional_integer(JsonVariantConst const &value, std::string_view path, T fallback, int64_t min = 0,
+        int64_t max = std::numeric_limits<T>::max()) noexcept
+    {
+        return read_integer(value, path, fallback, min, max, false);
+    }
+
+    /**
+    * Checks a setting that names one of a set of values, such as a log level.
+    */
+    template <class T, class Parse>
+    T read_name(JsonVariantConst const &value, std::string_view path, T fallback, Parse &&parse) noexcept
+    {
+        if (value.isNull())
+            return fallback;
+
+        if (!value.is<char const*>())
+        {
+            report(path, "type");
+            return fallback;
+        }
+
+        std::optional<T> const parsed = parse(std::string_view{ value.as<char const*>() });
+        if (!parsed)
+            report(path, "unknown");
+        return parsed.value_or(fallback);
+    }
+}
+
+namespace io
+{
+    std::optional<analog_input_t> analog_id_to_pin(std::string_view id) noexcept
     {
         if (id == "A0")
             return analog_input_t{ A0 };
@@ -50,75 +163,386 @@ namespace io
         if (id == "A5")
             return analog_input_t{ A5 };
 
-        return analog_input_t{ 255u };
+        return std::nullopt;
     }
 
-    input_source_t read_input(JsonVariantConst const &val) noexcept
+    std::optional<input_source_t> check_input(JsonVariantConst const &val, std::string_view path) noexcept
     {
-        
-        JsonObjectConst const &obj = val;
-        JsonVariantConst const &reg = obj["register"];
+        JsonVariantConst const &reg = val["register"];
         if (!reg.isNull())
-            return register_t{ static_cast<uint16_t>(reg) };
+        {
+            if (auto address = check_integer(reg, view(join(path, "register")), 0, UINT16_MAX))
+                return register_t{ static_cast<uint16_t>(*address) };
+            return std::nullopt;
+        }
 
-        JsonVariantConst const &ai = obj["analog_input"];
+        JsonVariantConst const &ai = val["analog_input"];
         if (!ai.isNull())
-            return analog_id_to_pin(static_cast<char const*>(ai));
+        {
+            display_text_t const ai_path = join(path, "analog_input");
+            if (!ai.is<char const*>())
+                report(view(ai_path), "type");
+            else if (auto pin = analog_id_to_pin(ai.as<char const*>()))
+                return *pin;
+            else
+                report(view(ai_path), "unknown");
+            return std::nullopt;
+        }
 
-        return register_t{ 9999u };
+        report(path, "missing");
+        return std::nullopt;
     }
 
-    input_source_t read_input(std::string_view key, JsonDocument &doc) noexcept
+    input_source_t read_input(std::string_view key, JsonDocument &doc, input_source_t fallback) noexcept
     {
         JsonVariantConst const &val = doc[key.data()];
-        return read_input(val);
+        if (val.isNull())
+        {
+            report(key, "missing");
+            return fallback;
+        }
+        return check_input(val, key).value_or(fallback);
     }
 
-    optional_input_t read_optional_input(std::string_view key, JsonDocument &doc) noexcept
+    optional_input_t read_optional_input(std::string_view key, JsonDocument &doc, input_source_t fallback) noexcept
     {
         JsonVariantConst const &val = doc[key.data()];
         if (val.isNull())
             return optional_input_t{};
 
-        return read_input(val);
+        return check_input(val, key).value_or(fallback);
+    }
+
+    std::optional<calibration_kind_t> parse_calibration_kind(std::string_view name) noexcept
+    {
+        if (name == "none")
+            return calibration_kind_t::none;
+        if (name == "linear")
+            return calibration_kind_t::linear;
+        if (name == "piecewise")
+            return calibration_kind_t::piecewise;
+        if (name == "polynomial")
+            return calibration_kind_t::polynomial;
+        return std::nullopt;
+    }
+
+    void read_calibration_points(JsonVariantConst const &cal, std::string_view path, calibration_t &read) noexcept
+    {
+        display_text_t const points_path = join(path, "points");
+        JsonVariantConst const &points = cal["points"];
+        if (!points.is<JsonArrayConst>())
+        {
+            report(view(points_path), points.isNull() ? "missing" : "type");
+            return;
+        }
+
+        for (JsonVariantConst const &obj : points.as<JsonArrayConst>())
+        {
+            if (read.count == max_calibration_points)
+            {
+                report(view(points_path), "too many");
+                return;
+            }
+
+            char buffer[max_display_text + 1u];
+            text_writer_t point_path(buffer, sizeof(buffer));
+            point_path.append(view(points_path)).append("[").append(read.count).append("]");
+            auto const raw = check_integer(obj["raw"], view(join(point_path.view(), "raw")), 0, read.raw_max);
+            auto const value = check_integer(obj["value"], view(join(point_path.view(), "value")), 0, UINT16_MAX);
+            if (!raw || !value)
+                return;
+
+            read.points[read.count++] = calibration_point_t
+            {
+                static_cast<uint16_t>(*raw),
+                static_cast<uint16_t>(*value)
+            };
+        }
+    }
+
+    void read_calibration_coefficients(JsonVariantConst const &cal, std::string_view path,
+        calibration_t &read) noexcept
+    {
+        display_text_t const coefficients_path = join(path, "coefficients");
+        JsonVariantConst const &coefficients = cal["coefficients"];
+        if (!coefficients.is<JsonArrayConst>())
+        {
+            report(view(coefficients_path), coefficients.isNull() ? "missing" : "type");
+            return;
+        }
+
+        for (JsonVariantConst const &coefficient : coefficients.as<JsonArrayConst>())
+        {
+            if (read.count == max_polynomial_terms)
+            {
+                report(view(coefficients_path), "too many");
+                return;
+            }
+
+            char buffer[max_display_text + 1u];
+            text_writer_t coefficient_path(buffer, sizeof(buffer));
+            coefficient_path.append(view(coefficients_path)).append("[").append(read.count).append("]");
+            auto const term = check_integer(coefficient, coefficient_path.view(), -max_polynomial_coefficient,
+                max_polynomial_coefficient);
+            if (!term)
+                return;
+
+            read.coefficients[read.count++] = static_cast<int32_t>(*term);
+        }
+    }
+
+    /**
+    * A calibration that cannot be used falls back to raw values, as there is no sensible default for a transducer.
+    */
+    calibration_t read_calibration(JsonDocument &doc, std::string_view key, input_source_t const &input) noexcept
+    {
+        JsonVariantConst const &cal = doc[key.data()];
+        if (cal.isNull())
+            return calibration_t{};
+
+        display_text_t const type_path = join(key, "type");
+        if (cal["type"].isNull())
+        {
+            report(view(type_path), "missing");
+            return calibration_t{};
+        }
+
+        uint16_t const default_raw_max = std::holds_alternative<analog_input_t>(input) ? analog_raw_max : UINT16_MAX;
+        calibration_t read
+        {
+            .kind = read_name(cal["type"], view(type_path), calibration_kind_t::none, parse_calibration_kind),
+            .count = 0u,
+            .raw_max = read_optional_integer(cal["raw_max"], view(join(key, "raw_max")), default_raw_max, 1)
+        };
+
+        uint32_t const reported = violation_count;
+        switch (read.kind)
+        {
+            case calibration_kind_t::linear:
+            case calibration_kind_t::piecewise:
+                read_calibration_points(cal, key, read);
+                break;
+            case calibration_kind_t::polynomial:
+                read_calibration_coefficients(cal, key, read);
+                break;
+            default:
+                break;
+        }
+
+        if (violation_count != reported)
+            return calibration_t{};
+
+        // Points must rise through the raw values, a line needs exactly two of them and a piecewise calibration at
+        // least two.
+        if (!valid_calibration(read))
+        {
+            bool const polynomial = read.kind == calibration_kind_t::polynomial;
+            bool const counted = polynomial || read.count < 2u || (read.kind == calibration_kind_t::linear &&
+                read.count != 2u);
+            report(view(join(key, polynomial ? "coefficients" : "points")), counted ? "count" : "order");
+            return calibration_t{};
+        }
+        return read;
+    }
+
+    drive_profile_t const& read_drive(JsonDocument &doc) noexcept
+    {
+        auto const find = [](std::string_view name)
+        {
+            drive_profile_t const *profile = find_drive_profile(name);
+            return profile != nullptr ? std::optional<drive_profile_t const*>{ profile } : std::nullopt;
+        };
+        return *read_name(doc["drive"], "drive", &default_drive, find);
+    }
+
+    init_registers_t read_init_registers(JsonDocument &doc, drive_profile_t const &drive) noexcept
+    {
+        init_registers_t init_regs;
+        JsonVariantConst const &regs = doc["init_registers"];
+        if (regs.isNull())
+        {
+            init_regs.assign(drive.init_registers.begin(), drive.init_registers.begin() + drive.init_register_count);
+            return init_regs;
+        }
+
+        if (!regs.is<JsonArrayConst>())
+        {
+            report("init_registers", "type");
+            return init_regs;
+        }
+
+        // An entry with a bad register or value is left out, there is nothing sensible to write instead.
+        std::size_t index = 0u;
+        for (JsonVariantConst const &obj : regs.as<JsonArrayConst>())
+        {
+            if (init_regs.full())
+            {
+                report("init_registers", "too many");
+                break;
+            }
+
+            char buffer[max_display_text + 1u];
+            text_writer_t path(buffer, sizeof(buffer));
+            path.append("init_registers[").append(index++).append("]");
+            auto const reg = check_integer(obj["reg"], view(join(path.view(), "reg")), 0, UINT16_MAX);
+            auto const value = check_integer(obj["value"], view(join(path.view(), "value")), 0, UINT16_MAX);
+            if (reg && value)
+            {
+                init_regs.push_back(init_register_t
+                {
+                    register_t{ static_cast<uint16_t>(*reg) },
+                    static_cast<uint16_t>(*value)
+                });
+            }
+        }
+        return init_regs;
     }
 
-    control::run_args_t read_run_args(JsonDocument &doc) noexcept
+    control::run_args_t read_run_args(JsonDocument &doc, drive_profile_t const &drive) noexcept
     {
-        uint16_t const run = doc["run_args"]["run"];
-        uint16_t const stop = doc["run_args"]["stop"];
-        return control::run_args_t{ .run = run, .stop = stop };
+        JsonVariantConst const &args = doc["run_args"];
+        control::run_args_t const read
+        {
+            .run = read_optional_integer(args["run"], "run_args.run", drive.run_args.run),
+            .stop = read_optional_integer(args["stop"], "run_args.stop", drive.run_args.stop)
+        };
+
+        // The pump's state is told apart by comparing against these, they cannot be the same.
+        if (read.run == read.stop)
+        {
+            report("run_args", "run = stop");
+            return drive.run_args;
+        }
+        return read;
     }
 
-    control::stepper_point_t read_stepper_point(JsonObjectConst const &levels, std::string_view key) noexcept
+    control::stepper_point_t read_stepper_point(JsonVariantConst const &levels, std::string_view key,
+        control::stepper_point_t fallback) noexcept
     {
-        JsonObjectConst const &stepper = levels[key.data()];
-        uint16_t const pressure = stepper["pressure"];
-        uint16_t const frequency = stepper["frequency"];
-        return control::stepper_point_t{ .pressure = pressure, .frequency = frequency };
+        display_text_t const path = join("stepper_levels", key);
+        JsonVariantConst const &stepper = levels[key.data()];
+        return control::stepper_point_t
+        {
+            .pressure = read_integer(stepper["pressure"], view(join(view(path), "pressure")), fallback.pressure),
+            .frequency = read_integer(stepper["frequency"], view(join(view(path), "frequency")), fallback.frequency, 0,
+                max_drive_frequency)
+        };
     }
 
     control::stepper_levels_t read_stepper_levels(JsonDocument &doc) noexcept
     {
-        JsonObjectConst const &lvls = doc["stepper_levels"];
-        control::stepper_point_t const stop = read_stepper_point(lvls, "stop");
-        control::stepper_point_t const fill = read_stepper_point(lvls, "fill");
-        control::stepper_point_t const start = read_stepper_point(lvls, "start");
+        JsonVariantConst const &lvls = doc["stepper_levels"];
+        control::stepper_levels_t const levels
+        {
+            .stop = read_stepper_point(lvls, "stop", io::stepper_levels.stop),
+            .fill = read_stepper_point(lvls, "fill", io::stepper_levels.fill),
+            .start = read_stepper_point(lvls, "start", io::stepper_levels.start)
+        };
+
+        // Mixing read and default levels could still leave them out of order, so the defaults replace all three.
+        if (!control::valid_levels(levels))
+        {
+            report("stepper_levels", "order");
+            return io::stepper_levels;
+        }
+        return levels;
+    }
+
+    control::stepper_levels_t to_drive_levels(control::stepper_levels_t levels, drive_profile_t const &drive) noexcept
+    {
+        for (control::stepper_point_t *point : { &levels.stop, &levels.fill, &levels.start })
+            point->frequency = to_drive_frequency(drive, point->frequency);
+        return levels;
+    }
 
-        return control::stepper_levels_t
+    recorder_args_t read_recorder_args(JsonDocument &doc) noexcept
+    {
+        recorder_args_t const defaults;
+        JsonVariantConst const &rec = doc["recorder"];
+        if (rec.isNull())
+            return defaults;
+
+        auto const default_interval = std::chrono::duration_cast<std::chrono::milliseconds>(defaults.interval).count();
+        auto const default_heartbeat = std::chrono::duration_cast<std::chrono::seconds>(defaults.heartbeat).count();
+        uint32_t const interval_ms = read_optional_integer(rec["interval_ms"], "recorder.interval_ms",
+            static_cast<uint32_t>(default_interval), 100, 3600000);
+        uint16_t const deadband = read_optional_integer(rec["pressure_deadband"], "recorder.pressure_deadband",
+            defaults.pressure_deadband);
+        uint32_t const heartbeat_s = read_optional_integer(rec["heartbeat_s"], "recorder.heartbeat_s",
+            static_cast<uint32_t>(default_heartbeat), 1, 86400);
+
+        return recorder_args_t
         {
-            .stop = stop,
-            .fill = fill,
-            .start = start
+            .interval = std::chrono::milliseconds{ interval_ms },
+            .pressure_deadband = deadband,
+            .heartbeat = std::chrono::seconds{ heartbeat_s }
         };
     }
-   
-    configuration_t read_config(std::string_view filename, modbus_t &modbus, logger_t &logger) noexcept
+
+    level_t read_log_level(JsonDocument &doc) noexcept
+    {
+        return read_name(doc["log_level"], "log_level", io::log_level, parse_level);
+    }
+
+    log_rotation_t read_log_rotation(JsonDocument &doc) noexcept
+    {
+        log_rotation_t const defaults;
+        JsonVariantConst const &rotation = doc["log_rotation"];
+        uint32_t const segment_kb = read_optional_integer(rotation["segment_kb"], "log_rotation.segment_kb",
+            defaults.segment_size / 1024u, 1, 1024 * 1024);
+        return log_rotation_t
+        {
+            .segments = read_optional_integer(rotation["segments"], "log_rotation.segments", defaults.segments, 2,
+                max_log_segments),
+            .segment_size = segment_kb * 1024u
+        };
+    }
+
+    control::cycle_args_t read_cycle_args(JsonDocument &doc) noexcept
+    {
+        control::cycle_args_t const defaults;
+        return control::cycle_args_t
+        {
+            .max_starts_per_hour = read_optional_integer(doc["max_starts_per_hour"], "max_starts_per_hour",
+                defaults.max_starts_per_hour, 1)
+        };
+    }
+
+    display_args_t read_display_args(JsonDocument &doc, control::stepper_levels_t const &levels,
+        control::run_args_t const &run_args, drive_profile_t const &drive) noexcept
+    {
+        display_args_t const defaults;
+        JsonVariantConst const &display = doc["display"];
+        uint16_t const top = std::max({ levels.stop.frequency, levels.fill.frequency, levels.start.frequency });
+        uint16_t const full_scale = read_optional_integer(display["full_scale_frequency"],
+            "display.full_scale_frequency", uint16_t{ 0u }, 1, max_drive_frequency);
+        return display_args_t
+        {
+            .mode = read_name(display["mode"], "display.mode", defaults.mode, parse_display_mode),
+            .full_scale_frequency = full_scale == 0u ? top : to_drive_frequency(drive, full_scale),
+            .run = run_args.run,
+            .pressure_decimals = read_optional_integer(display["pressure_decimals"], "display.pressure_decimals",
+                defaults.pressure_decimals, 0, max_display_decimals),
+            .frequency_decimals = read_optional_integer(display["frequency_decimals"], "display.frequency_decimals",
+                defaults.frequency_decimals, 0, max_display_decimals)
+        };
+    }
+
+    chrono::duration_t read_repeat_window(JsonDocument &doc) noexcept
     {
-        configuration_t default_config
+        uint32_t const default_s = std::chrono::duration_cast<std::chrono::seconds>(io::log_repeat_window).count();
+        return std::chrono::seconds{ read_optional_integer(doc["log_repeat_window_s"], "log_repeat_window_s",
+            default_s, 0, 86400) };
+    }
+
+    configuration_t default_configuration(modbus_t &modbus) noexcept
+    {
+        return configuration_t
         {
             io::modbus_id,
             io::modbus_serial_speed,
+            default_drive.turnaround_ms,
+            &default_drive,
             init_registers_t {},
             control::args_t
             {
@@ -130,46 +554,52 @@ namespace io
                 stepper_levels,
                 run_args,
                 flood_trigger,
-                flood_timeout
+                flood_timeout,
+                calibration_t{},
+                calibration_t{}
             }
         };
+    }
 
-        File file = SD.open(filename.data());
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, file);
-        if (error)
-        {
-            logger.log_on_failure(!static_cast<bool>(error), error.c_str());
-            return default_config;
-        }
-
-        uint32_t const modbus_buad = doc["modbus_baud"];
-        uint8_t const modbus_id = static_cast<uint32_t>(doc["modbus_id"]);
-        
-        init_registers_t init_regs;
-        JsonArray jinitregs = doc["init_registers"];
-        std::size_t const num_regs = std::min(init_regs.capacity(), jinitregs.size());
-        auto itr_end = jinitregs.begin();
-        for (std::size_t i = 0; i != num_regs; ++i, ++itr_end) {};
-        std::transform(jinitregs.begin(), itr_end, std::back_inserter(init_regs), [&](JsonObjectConst const &obj)
-        {
-            return read_init_register(obj);
-        });
+    configuration_t read_document(JsonDocument &doc, modbus_t &modbus) noexcept
+    {
+        uint32_t const modbus_buad = read_integer(doc["modbus_baud"], "modbus_baud", io::modbus_serial_speed, 300,
+            1000000);
+        uint8_t const modbus_id = read_integer(doc["modbus_id"], "modbus_id", io::modbus_id, 1, 247);
 
-        register_t const run_reg{ static_cast<uint16_t>(doc["run_register"]) };
-        register_t const frequency_reg{ static_cast<uint16_t>(doc["frequency_register"]) };
-        optional_input_t const flood_input = read_optional_input("flood_input", doc);
-        input_source_t const pressure_input = read_input("pressure_input", doc);
+        // The drive profile supplies the registers, run/stop patterns and init registers, any of which can still be
+        // given in the file to override it.
+        drive_profile_t const &drive = read_drive(doc);
+        init_registers_t const init_regs = read_init_registers(doc, drive);
+        register_t const run_reg{ read_optional_integer(doc["run_register"], "run_register", drive.run_reg.address) };
+        register_t const frequency_reg{ read_optional_integer(doc["frequency_register"], "frequency_register",
+            drive.frequency_reg.address) };
+        optional_input_t const flood_input = read_optional_input("flood_input", doc, reg_flood);
+        input_source_t const pressure_input = read_input("pressure_input", doc, reg_pressure);
+        calibration_t const pressure_calibration = read_calibration(doc, "pressure_calibration", pressure_input);
+        calibration_t const flood_calibration = flood_input ?
+            read_calibration(doc, "flood_calibration", *flood_input) : calibration_t{};
 
-        control::stepper_levels_t const stepper_lvls = read_stepper_levels(doc);
-        control::run_args_t const run_args = read_run_args(doc);
-        uint16_t const flood_trigger_value = doc["flood_trigger_value"];
-        chrono::duration_t const flood_timeout = std::chrono::minutes{ static_cast<unsigned long>(doc["flood_timeout"]) };
+        control::stepper_levels_t const stepper_lvls = to_drive_levels(read_stepper_levels(doc), drive);
+        control::run_args_t const run_args = read_run_args(doc, drive);
+        uint16_t const flood_trigger_value = read_integer(doc["flood_trigger_value"], "flood_trigger_value",
+            io::flood_trigger);
+        auto const default_timeout = std::chrono::duration_cast<std::chrono::minutes>(io::flood_timeout).count();
+        chrono::duration_t const flood_timeout = std::chrono::minutes{ read_integer(doc["flood_timeout"],
+            "flood_timeout", static_cast<uint32_t>(default_timeout), 0, 24 * 60) };
+        recorder_args_t const recorder = read_recorder_args(doc);
+        level_t const level = read_log_level(doc);
+        chrono::duration_t const repeat_window = read_repeat_window(doc);
+        log_rotation_t const rotation = read_log_rotation(doc);
+        control::cycle_args_t const cycles = read_cycle_args(doc);
+        display_args_t const display = read_display_args(doc, stepper_lvls, run_args, drive);
 
         return configuration_t
         {
             modbus_id,
             modbus_buad,
+            drive.turnaround_ms,
+            &drive,
             init_regs,
             control::args_t
             {
@@ -181,8 +611,123 @@ namespace io
                 stepper_lvls,
                 run_args,
                 flood_trigger_value,
-                flood_timeout
-            }
+                flood_timeout,
+                pressure_calibration,
+                flood_calibration
+            },
+            recorder,
+            level,
+            repeat_window,
+            rotation,
+            cycles,
+            display
+        };
+    }
+   
+    /**
+    * Parses the configuration into the static arena, keeping only the keys in config_filter.  Whatever the input,
+    * the parse never takes more memory than the arena holds; a file that needs more fails with NoMemory.
+    */
+    template <class... Input>
+    std::optional<configuration_t> parse_filtered(modbus_t &modbus, logger_t &logger, Input&&... input) noexcept
+    {
+        arena.reset();
+        JsonDocument filter{ &arena };
+        JsonDocument doc{ &arena };
+        DeserializationError error = deserializeJson(filter, config_filter.data(), config_filter.size());
+        if (!error)
+            error = deserializeJson(doc, std::forward<Input>(input)..., DeserializationOption::Filter(filter));
+
+        logger.log(LOG_MSG("config arena peak: "), static_cast<uint32_t>(arena.peak()));
+        if (error)
+        {
+            logger.log_on_failure(!static_cast<bool>(error), error.c_str());
+            return std::nullopt;
+        }
+
+        // Every setting that fell back to its default is reported, on the display as well as in the log.
+        violations.clear();
+        violation_count = 0u;
+        configuration_t const config = read_document(doc, modbus);
+        for (display_text_t const &violation : violations)
+            logger.log_on_failure<level_t::warning>(false, view(violation));
+        if (violation_count != 0u)
+            logger.log<level_t::warning>(LOG_MSG("config errors: "), violation_count);
+        return config;
+    }
+
+    /**
+    * Only a configuration without violations is cached, so the violations are reported again on every boot until
+    * the file is fixed.
+    */
+    void cache_config(config_stamp_t stamp, configuration_t const &config) noexcept
+    {
+        if (violation_count == 0u)
+            store_config_cache(config_cache_file, stamp, config);
+    }
+
+    configuration_t read_config(std::string_view filename, modbus_t &modbus, logger_t &logger) noexcept
+    {
+        // A configuration compiled from this very JSON on an earlier boot is loaded in one read, skipping the parse.
+        File file = SD.open(filename.data());
+        config_stamp_t const stamp = stamp_config(file);
+        if (auto cached = load_config_cache(config_cache_file, stamp, modbus))
+        {
+            logger.log(LOG_MSG("config from cache"));
+            return *cached;
+        }
+
+        std::optional<configuration_t> config = parse_filtered(modbus, logger, file);
+        if (!config)
+            return default_configuration(modbus);
+
+        config->json = stamp;
+        cache_config(stamp, *config);
+        return *config;
+    }
+
+    std::optional<configuration_t> parse_config(File &file, config_stamp_t stamp, modbus_t &modbus,
+        logger_t &logger) noexcept
+    {
+        std::optional<configuration_t> config = parse_filtered(modbus, logger, file);
+        if (config)
+        {
+            config->json = stamp;
+            cache_config(stamp, *config);
+        }
+        return config;
+    }
+
+    std::optional<std::string_view> restart_setting(configuration_t const &running, configuration_t const &reloaded)
+        noexcept
+    {
+        // The drive also decides the turnaround and the units the levels were scaled to.
+        if (reloaded.drive != running.drive)
+            return "drive";
+        if (reloaded.modbus_id != running.modbus_id)
+            return "modbus_id";
+        if (reloaded.modbus_buad != running.modbus_buad)
+            return "modbus_baud";
+
+        // Start-up registers were written once, before the pump started.
+        auto const same_register = [](init_register_t const &lhs, init_register_t const &rhs)
+        {
+            return lhs.reg.address == rhs.reg.address && lhs.value == rhs.value;
         };
+        if (!std::equal(reloaded.init_registers.begin(), reloaded.init_registers.end(),
+            running.init_registers.begin(), running.init_registers.end(), same_register))
+            return "init_registers";
+
+        control::args_t const &next = reloaded.args;
+        control::args_t const &args = running.args;
+        if (next.run_reg.address != args.run_reg.address)
+            return "run_register";
+        if (next.frequency_reg.address != args.frequency_reg.address)
+            return "frequency_register";
+        if (!same_input(next.pressure, args.pressure))
+            return "pressure_input";
+        if (!same_input(next.flood, args.flood))
+            return "flood_input";
+        return std::nullopt;
     }
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "checksum.hpp"
+#include "config_cache.hpp"
+
+namespace
+{
+    constexpr uint32_t image_magic = 0x31474643u;   // "CFG1"
+
+    // Bump whenever a type held in the image changes meaning without changing size.
+    constexpr uint16_t image_version = 2u;
+
+    /**
+    * configuration_t flattened into plain data.  It is only ever read back by the firmware that wrote it, so the
+    * fields are kept in native layout and copied in and out with a single read or write.
+    */
+    struct config_image_t
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        io::config_stamp_t json;
+
+        uint8_t modbus_id;
+        uint8_t init_register_count;
+        uint8_t drive;                  /**< Index into drive_profiles. */
+        uint32_t modbus_baud;
+        uint16_t modbus_turnaround_ms;
+        std::array<io::init_register_t, io::max_init_registers> init_registers;
+
+        io::register_t run_reg;
+        io::register_t frequency_reg;
+        io::input_source_t pressure;
+        io::optional_input_t flood;
+        control::stepper_levels_t levels;
+        control::run_args_t run_args;
+        uint16_t flood_trigger;
+        chrono::duration_t flood_timeout;
+        io::calibration_t pressure_calibration;
+        io::calibration_t flood_calibration;
+
+        io::recorder_args_t recorder;
+        io::level_t log_level;
+        chrono::duration_t log_repeat_window;
+        io::log_rotation_t log_rotation;
+        control::cycle_args_t cycles;
+        io::display_args_t display;
+
+        uint32_t crc;
+    };
+
+    static_assert(std::is_trivially_copyable_v<config_image_t>, "the config image must be plain data");
+    static_assert(sizeof(config_image_t) <= UINT16_MAX, "the config image size must fit its header");
+
+    constexpr std::size_t crc_offset = offsetof(config_image_t, crc);
+
+    uint32_t image_crc(config_image_t const &image) noexcept
+    {
+        return io::crc32(reinterpret_cast<uint8_t const*>(&image), crc_offset);
+    }
+
+    bool same_stamp(io::config_stamp_t const &lhs, io::config_stamp_t const &rhs) noexcept
+    {
+        return lhs.size == rhs.size && lhs.crc == rhs.crc;
+    }
+}
+
+namespace io
+{
+    config_stamp_t stamp_config(File &file) noexcept
+    {
+        config_stamp_t stamp{ file.size(), 0u };
+        std::array<uint8_t, 64u> chunk;
+        for (int n = file.read(chunk.data(), chunk.size()); n > 0; n = file.read(chunk.data(), chunk.size()))
+            stamp.crc = crc32(chunk.data(), static_cast<std::size_t>(n), stamp.crc);
+
+        file.seek(0u);
+        return stamp;
+    }
+
+    std::optional<configuration_t> load_config_cache(std::string_view filename, config_stamp_t json,
+        modbus_t &modbus) noexcept
+    {
+        File file = SD.open(filename.data());
+        if (!file)
+            return std::nullopt;
+
+        config_image_t image;
+        int const read = file.read(&image, sizeof(image));
+        file.close();
+
+        if (read != static_cast<int>(sizeof(image)) || image.magic != image_magic || image.version != image_version ||
+            image.size != sizeof(image) || !same_stamp(image.json, json) || image.crc != image_crc(image) ||
+            image.init_register_count > image.init_registers.size() || image.drive >= drive_profiles.size())
+            return std::nullopt;
+
+        configuration_t config;
+        config.modbus_id = image.modbus_id;
+        config.modbus_buad = image.modbus_baud;
+        config.modbus_turnaround_ms = image.modbus_turnaround_ms;
+        config.drive = drive_profiles[image.drive];
+        config.init_registers.assign(image.init_registers.begin(),
+            image.init_registers.begin() + image.init_register_count);
+        config.args = control::args_t
+        {
+            &modbus,
+            image.run_reg,
+            image.frequency_reg,
+            image.pressure,
+            image.flood,
+            image.levels,
+            image.run_args,
+            image.flood_trigger,
+            image.flood_timeout,
+            image.pressure_calibration,
+            image.flood_calibration
+        };
+        config.recorder = image.recorder;
+        config.log_level = image.log_level;
+        config.log_repeat_window = image.log_repeat_window;
+        config.log_rotation = image.log_rotation;
+        config.cycles = image.cycles;
+        config.display = image.display;
+        config.json = json;
+        return config;
+    }
+
+    bool store_config_cache(std::string_view filename, config_stamp_t json, configuration_t const &config) noexcept
+    {
+        // Zeroed first so padding is part of the CRC deterministically.
+        config_image_t image;
+        std::memset(static_cast<void*>(&image), 0, sizeof(image));
+        image.magic = image_magic;
+        image.version = image_version;
+        image.size = static_cast<uint16_t>(sizeof(image));
+        image.json = json;
+
+        image.modbus_id = config.modbus_id;
+        image.modbus_baud = config.modbus_buad;
+        image.modbus_turnaround_ms = config.modbus_turnaround_ms;
+        image.drive = static_cast<uint8_t>(std::find(drive_profiles.begin(), drive_profiles.end(), config.drive) -
+            drive_profiles.begin());
+        image.init_register_count = static_cast<uint8_t>(config.init_registers.size());
+        std::copy(config.init_registers.begin(), config.init_registers.end(), image.init_registers.begin());
+
+        control::args_t const &args = config.args;
+        image.run_reg = args.run_reg;
+        image.frequency_reg = args.frequency_reg;
+        image.pressure = args.pressure;
+        image.flood = args.flood;
+        image.levels = args.levels;
+        image.run_args = args.run_args;
+        image.flood_trigger = args.flood_trigger_value;
+        image.flood_timeout = args.flood_timeout;
+        image.pressure_calibration = args.pressure_calibration;
+        image.flood_calibration = args.flood_calibration;
+
+        image.recorder = config.recorder;
+        image.log_level = config.log_level;
+        image.log_repeat_window = config.log_repeat_window;
+        image.log_rotation = config.log_rotation;
+        image.cycles = config.cycles;
+        image.display = config.display;
+        image.crc = image_crc(image);
+
+        SD.remove(filename.data());
+        File file = SD.open(filename.data(), O_READ | O_WRITE | O_CREAT);
+        if (!file)
+            return false;
+
+        std::size_t const written = file.write(reinterpret_cast<uint8_t const*>(&image), sizeof(image));
+        file.close();
+        return written == sizeof(image);
+    }
+}
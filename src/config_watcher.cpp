@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+
+#include "checksum.hpp"
+#include "config_watcher.hpp"
+
+namespace io
+{
+    config_watcher_t::config_watcher_t(modbus_t &modbus, logger_t &logger) noexcept
+    : modbus_(modbus), logger_(logger), filename_(nullptr), handler_(nullptr), stamped_(0u), checking_(false)
+    {}
+
+    void config_watcher_t::begin(std::string_view filename, config_stamp_t current, config_handler_t handler) noexcept
+    {
+        filename_ = filename.data();
+        current_ = current;
+        handler_ = handler;
+    }
+
+    void config_watcher_t::update(chrono::time_point_t now) noexcept
+    {
+        if (filename_ == nullptr)
+            return;
+
+        if (checking_)
+        {
+            read_chunk();
+            return;
+        }
+
+        if (now < next_check_)
+            return;
+
+        next_check_ = now + config_check_interval;
+        start_check();
+    }
+
+    void config_watcher_t::start_check() noexcept
+    {
+        file_ = SD.open(filename_);
+        if (!file_)
+            return;
+
+        reading_ = config_stamp_t{ file_.size(), 0u };
+        stamped_ = 0u;
+        checking_ = true;
+    }
+
+    void config_watcher_t::read_chunk() noexcept
+    {
+        std::array<uint8_t, config_read_chunk> chunk;
+        std::size_t const wanted = std::min<std::size_t>(chunk.size(), reading_.size - stamped_);
+        int const read = wanted == 0u ? 0 : file_.read(chunk.data(), static_cast<uint16_t>(wanted));
+        if (read > 0)
+        {
+            reading_.crc = crc32(chunk.data(), static_cast<std::size_t>(read), reading_.crc);
+            stamped_ += static_cast<uint32_t>(read);
+        }
+
+        if (read <= 0 || stamped_ == reading_.size)
+            finish_check();
+    }
+
+    void config_watcher_t::finish_check() noexcept
+    {
+        checking_ = false;
+        if (stamped_ != reading_.size || (reading_.size == current_.size && reading_.crc == current_.crc))
+        {
+            file_.close();
+            return;
+        }
+
+        // A file that fails to parse is not retried until it changes again.  Should it change again between the
+        // stamp and the parse, the next check sees a new stamp and parses it once more.
+        current_ = reading_;
+        file_.seek(0u);
+        auto config = parse_config(file_, reading_, modbus_, logger_);
+        file_.close();
+        if (config && handler_ != nullptr)
+            handler_(*config);
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "checksum.hpp"
+#include "counter_store.hpp"
+#include "encoding.hpp"
+
+namespace
+{
+    constexpr uint32_t slot_magic = 0x31535043u;   // "CPS1"
+    constexpr uint32_t blank_word = 0xFFFFFFFFu;
+
+    // Slot layout: magic, sequence, counters, then the CRC-32 of everything before it in the last four bytes.
+    constexpr std::size_t magic_offset = 0u;
+    constexpr std::size_t sequence_offset = 4u;
+    constexpr std::size_t counters_offset = 8u;
+    constexpr std::size_t crc_offset = io::counter_slot_size - 4u;
+
+    using slot_buffer_t = std::array<uint8_t, io::counter_slot_size>;
+
+    void encode(io::pump_counters_t const &counters, uint8_t *out) noexcept
+    {
+        io::store_le(counters.starts, out);
+        io::store_le(counters.run_seconds, out + 4u);
+        io::store_le(counters.flood_trips, out + 8u);
+        io::store_le(counters.modbus_faults, out + 12u);
+        out += 16u;
+        for (io::frequency_time_t const &ft : counters.frequencies)
+        {
+            io::store_le(ft.frequency, out);
+            io::store_le(ft.seconds, out + 2u);
+            out += 6u;
+        }
+    }
+
+    io::pump_counters_t decode(uint8_t const *in) noexcept
+    {
+        io::pump_counters_t counters;
+        counters.starts = io::load_le<uint32_t>(in);
+        counters.run_seconds = io::load_le<uint32_t>(in + 4u);
+        counters.flood_trips = io::load_le<uint32_t>(in + 8u);
+        counters.modbus_faults = io::load_le<uint32_t>(in + 12u);
+        in += 16u;
+        for (io::frequency_time_t &ft : counters.frequencies)
+        {
+            ft.frequency = io::load_le<uint16_t>(in);
+            ft.seconds = io::load_le<uint32_t>(in + 2u);
+            in += 6u;
+        }
+        return counters;
+    }
+
+    static_assert(counters_offset + 16u + 6u * io::counted_frequencies <= crc_offset, "counters do not fit a slot");
+
+    constexpr uint32_t slot_address(std::size_t slot) noexcept
+    {
+        return static_cast<uint32_t>(slot * io::counter_slot_size);
+    }
+}
+
+namespace io
+{
+    counter_store_t::counter_store_t(data_flash_t &flash) noexcept
+    : flash_(flash), next_slot_(0u), sequence_(0u), ready_(false)
+    {}
+
+    std::optional<pump_counters_t> counter_store_t::begin() noexcept
+    {
+        ready_ = flash_.begin();
+        if (!ready_)
+            return std::nullopt;
+
+        // The block whose first slot has the highest sequence number is the one being filled.
+        std::optional<slot_t> newest;
+        std::size_t block = 0u;
+        for (std::size_t b = 0u; b != data_flash_blocks; ++b)
+        {
+            std::optional<slot_t> const first = read_slot(b * counter_slots_per_block);
+            if (first && (!newest || first->sequence > newest->sequence))
+            {
+                newest = first;
+                block = b;
+            }
+        }
+
+        if (!newest)
+            return std::nullopt;
+
+        // Slots are programmed in order, so binary search the block for its first blank slot.
+        std::size_t const base = block * counter_slots_per_block;
+        std::size_t used = 1u;
+        std::size_t last = counter_slots_per_block;
+        while (used != last)
+        {
+            std::size_t const mid = used + (last - used) / 2u;
+            if (blank(base + mid))
+                last = mid;
+            else
+                used = mid + 1u;
+        }
+
+        // New slots always go after the last programmed one, even if a power loss left it torn.
+        next_slot_ = (base + used) % counter_slots;
+        for (std::size_t i = used; i-- != 1u;)
+        {
+            std::optional<slot_t> const slot = read_slot(base + i);
+            if (slot && slot->sequence > newest->sequence)
+            {
+                newest = slot;
+                break;
+            }
+        }
+
+        sequence_ = newest->sequence + 1u;
+        return newest->counters;
+    }
+
+    bool counter_store_t::commit(pump_counters_t const &counters) noexcept
+    {
+        if (!ready_)
+            return false;
+
+        std::size_t const slot = next_slot_;
+        next_slot_ = (next_slot_ + 1u) % counter_slots;
+
+        // Moving on to a new block erases the oldest snapshots, the previous block still holds the newest one.
+        if (slot % counter_slots_per_block == 0u && !flash_.erase(slot / counter_slots_per_block))
+            return false;
+
+        slot_buffer_t buffer{};
+        store_le(slot_magic, buffer.data() + magic_offset);
+        store_le(sequence_, buffer.data() + sequence_offset);
+        encode(counters, buffer.data() + counters_offset);
+        store_le(crc32(buffer.data(), crc_offset), buffer.data() + crc_offset);
+        ++sequence_;
+
+        return flash_.write(slot_address(slot), buffer.data(), buffer.size());
+    }
+
+    bool counter_store_t::blank(std::size_t slot) const noexcept
+    {
+        std::array<uint8_t, 4u> magic;
+        flash_.read(slot_address(slot) + magic_offset, magic.data(), magic.size());
+        return load_le<uint32_t>(magic.data()) == blank_word;
+    }
+
+    std::optional<counter_store_t::slot_t> counter_store_t::read_slot(std::size_t slot) const noexcept
+    {
+        slot_buffer_t buffer;
+        flash_.read(slot_address(slot), buffer.data(), buffer.size());
+        if (load_le<uint32_t>(buffer.data() + magic_offset) != slot_magic)
+            return std::nullopt;
+
+        if (crc32(buffer.data(), crc_offset) != load_le<uint32_t>(buffer.data() + crc_offset))
+            return std::nullopt;
+
+        return slot_t{ load_le<uint32_t>(buffer.data() + sequence_offset), decode(buffer.data() + counters_offset) };
+    }
+}
@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "cycle_analytics.hpp"
+#include "number_format.hpp"
+
+namespace
+{
+    constexpr int64_t slot_ms = std::chrono::duration_cast<std::chrono::milliseconds>(control::cycle_slot).count();
+    constexpr int64_t hour_ms = slot_ms * control::cycle_slots_per_hour;
+    constexpr int64_t day_ms = hour_ms * control::cycle_hours;
+    constexpr int64_t day_slots = static_cast<int64_t>(control::cycle_slots_per_hour * control::cycle_hours);
+
+    constexpr uint32_t min_or_zero(uint32_t value) noexcept
+    {
+        return value == std::numeric_limits<uint32_t>::max() ? 0u : value;
+    }
+}
+
+namespace control
+{
+    cycle_analytics_t::cycle_analytics_t(io::logger_t &lggr) noexcept
+    : logger_(lggr), slot_starts_{}, hours_{}, slot_(0), first_ms_(0), running_(false), warned_(false)
+    {}
+
+    void cycle_analytics_t::begin(cycle_args_t args) noexcept
+    {
+        args_ = args;
+    }
+
+    void cycle_analytics_t::configure(cycle_args_t args) noexcept
+    {
+        args_ = args;
+    }
+
+    void cycle_analytics_t::record(sample_t const &sample) noexcept
+    {
+        int64_t const now = chrono::to_monotonic(sample.time).milliseconds;
+        if (!last_ms_)
+        {
+            first_ms_ = now;
+            last_ms_ = now;
+            slot_ = now / slot_ms;
+        }
+
+        advance(now);
+        hour_t &hour = current_hour();
+        if (running_)
+            hour.run_ms += static_cast<uint32_t>(now - *last_ms_);
+        last_ms_ = now;
+
+        if (sample.running == running_)
+            return;
+
+        // The period that just ended only counts if it began with a transition, not when the controller started.
+        std::optional<uint32_t> period;
+        if (transition_ms_)
+            period = static_cast<uint32_t>(now - *transition_ms_);
+        transition_ms_ = now;
+        running_ = sample.running;
+
+        if (running_)
+        {
+            ++slot_starts_[static_cast<std::size_t>(slot_ % cycle_slots_per_hour)];
+            ++hour.starts;
+            if (period)
+            {
+                ++hour.offs;
+                hour.off_total_ms += *period;
+                hour.min_off_ms = std::min(hour.min_off_ms, *period);
+            }
+            check_short_cycling();
+        }
+        else if (period)
+        {
+            ++hour.runs;
+            hour.run_total_ms += *period;
+            hour.min_run_ms = std::min(hour.min_run_ms, *period);
+        }
+    }
+
+    cycle_stats_t cycle_analytics_t::stats() const noexcept
+    {
+        cycle_stats_t stats;
+        stats.starts_hour = starts_hour();
+
+        uint32_t runs = 0u;
+        uint32_t offs = 0u;
+        uint64_t run_ms = 0u;
+        uint64_t run_total_ms = 0u;
+        uint64_t off_total_ms = 0u;
+        uint32_t min_run_ms = std::numeric_limits<uint32_t>::max();
+        uint32_t min_off_ms = std::numeric_limits<uint32_t>::max();
+        for (hour_t const &hour : hours_)
+        {
+            stats.starts_day += hour.starts;
+            runs += hour.runs;
+            offs += hour.offs;
+            run_ms += hour.run_ms;
+            run_total_ms += hour.run_total_ms;
+            off_total_ms += hour.off_total_ms;
+            min_run_ms = std::min(min_run_ms, hour.min_run_ms);
+            min_off_ms = std::min(min_off_ms, hour.min_off_ms);
+        }
+
+        stats.mean_run_ms = runs == 0u ? 0u : static_cast<uint32_t>(run_total_ms / runs);
+        stats.mean_off_ms = offs == 0u ? 0u : static_cast<uint32_t>(off_total_ms / offs);
+        stats.min_run_ms = min_or_zero(min_run_ms);
+        stats.min_off_ms = min_or_zero(min_off_ms);
+
+        int64_t const covered = last_ms_ ? std::min(*last_ms_ - first_ms_, day_ms) : 0;
+        stats.duty_permille = covered <= 0 ? 0u : static_cast<uint16_t>(std::min<uint64_t>(run_ms * 1000u / covered, 1000u));
+        return stats;
+    }
+
+    void cycle_analytics_t::dump_stats(Print &out) const noexcept
+    {
+        char buffer[96];
+        cycle_stats_t const s = stats();
+        io::text_writer_t line(buffer, sizeof(buffer));
+        line.append("cycles: starts_hour=").append(s.starts_hour)
+            .append(" starts_day=").append(s.starts_day)
+            .append(" duty_permille=").append(s.duty_permille);
+        out.println(line.c_str());
+
+        line.clear();
+        line.append("  run_ms: mean=").append(s.mean_run_ms)
+            .append(" min=").append(s.min_run_ms)
+            .append(" off_ms: mean=").append(s.mean_off_ms)
+            .append(" min=").append(s.min_off_ms);
+        out.println(line.c_str());
+    }
+
+    void cycle_analytics_t::advance(int64_t now) noexcept
+    {
+        int64_t const slot = now / slot_ms;
+        if (slot - slot_ > day_slots)
+        {
+            // Nothing of the last day is left in the window.
+            slot_starts_.fill(0u);
+            hours_.fill(hour_t{});
+            slot_ = slot;
+            return;
+        }
+
+        while (slot_ < slot)
+        {
+            ++slot_;
+            slot_starts_[static_cast<std::size_t>(slot_ % cycle_slots_per_hour)] = 0u;
+            if (slot_ % cycle_slots_per_hour == 0)
+            {
+                hour_t &next = current_hour();
+                report(hours_[static_cast<std::size_t>((slot_ / cycle_slots_per_hour + cycle_hours - 1) % cycle_hours)]);
+                next = hour_t{};
+            }
+        }
+    }
+
+    void cycle_analytics_t::report(hour_t const &hour) noexcept
+    {
+        logger_.log(LOG_MSG("cycle starts/h: "), hour.starts);
+        logger_.log(LOG_MSG("cycle duty %: "), static_cast<uint32_t>(uint64_t{ hour.run_ms } * 100u / hour_ms));
+        logger_.log(LOG_MSG("cycle min run s: "), min_or_zero(hour.min_run_ms) / 1000u);
+        logger_.log(LOG_MSG("cycle min off s: "), min_or_zero(hour.min_off_ms) / 1000u);
+    }
+
+    void cycle_analytics_t::check_short_cycling() noexcept
+    {
+        uint32_t const starts = starts_hour();
+        if (starts <= args_.max_starts_per_hour)
+        {
+            warned_ = false;
+            return;
+        }
+
+        // Warn once each time the limit is crossed, not on every start while above it.
+        if (warned_)
+            return;
+
+        warned_ = true;
+        logger_.log<io::level_t::warning>(LOG_MSG("short cycling"));
+        logger_.log<io::level_t::warning>(LOG_MSG("cycle starts/h: "), starts);
+    }
+
+    uint32_t cycle_analytics_t::starts_hour() const noexcept
+    {
+        return std::accumulate(slot_starts_.begin(), slot_starts_.end(), uint32_t{ 0u });
+    }
+
+    cycle_analytics_t::hour_t& cycle_analytics_t::current_hour() noexcept
+    {
+        return hours_[static_cast<std::size_t>((slot_ / cycle_slots_per_hour) % cycle_hours)];
+    }
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "data_flash.hpp"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include "r_flash_lp.h"
+
+namespace
+{
+    constexpr uint32_t data_flash_base = 0x40100000u;
+
+    // The FSP driver keeps a pointer to its configuration, so both live for the whole program.
+    flash_lp_instance_ctrl_t flash_ctrl;
+    flash_cfg_t flash_cfg;
+}
+
+namespace io
+{
+    data_flash_t::data_flash_t() noexcept
+    : open_(false)
+    {}
+
+    bool data_flash_t::begin() noexcept
+    {
+        flash_cfg.data_flash_bgo = false;
+        flash_cfg.p_callback = nullptr;
+        flash_cfg.p_context = nullptr;
+        flash_cfg.p_extend = nullptr;
+        flash_cfg.ipl = BSP_IRQ_DISABLED;
+        flash_cfg.irq = FSP_INVALID_VECTOR;
+
+        open_ = R_FLASH_LP_Open(&flash_ctrl, &flash_cfg) == FSP_SUCCESS;
+        return open_;
+    }
+
+    void data_flash_t::read(uint32_t offset, void *out, std::size_t size) const noexcept
+    {
+        // Data flash is memory mapped for reading.
+        std::memcpy(out, reinterpret_cast<void const*>(data_flash_base + offset), size);
+    }
+
+    bool data_flash_t::write(uint32_t offset, void const *data, std::size_t size) noexcept
+    {
+        if (!open_ || offset + size > data_flash_size)
+            return false;
+
+        fsp_err_t const err = R_FLASH_LP_Write(&flash_ctrl, reinterpret_cast<uint32_t>(data), data_flash_base + offset, size);
+        return err == FSP_SUCCESS;
+    }
+
+    bool data_flash_t::erase(std::size_t block) noexcept
+    {
+        if (!open_ || block >= data_flash_blocks)
+            return false;
+
+        return R_FLASH_LP_Erase(&flash_ctrl, data_flash_base + block * data_flash_block_size, 1u) == FSP_SUCCESS;
+    }
+}
+
+#else
+
+namespace io
+{
+    data_flash_t::data_flash_t() noexcept
+    : file_(nullptr)
+    {}
+
+    data_flash_t::~data_flash_t() noexcept
+    {
+        if (file_ != nullptr)
+            std::fclose(file_);
+    }
+
+    bool data_flash_t::begin() noexcept
+    {
+        if (file_ != nullptr)
+            std::fclose(file_);
+
+        file_ = std::fopen(data_flash_file, "r+b");
+        if (file_ != nullptr)
+            return true;
+
+        // A new stand-in starts out erased.
+        file_ = std::fopen(data_flash_file, "w+b");
+        if (file_ == nullptr)
+            return false;
+
+        std::array<uint8_t, data_flash_block_size> erased;
+        erased.fill(0xFFu);
+        for (std::size_t i = 0; i != data_flash_blocks; ++i)
+            std::fwrite(erased.data(), 1u, erased.size(), file_);
+        std::fflush(file_);
+        return true;
+    }
+
+    void data_flash_t::read(uint32_t offset, void *out, std::size_t size) const noexcept
+    {
+        std::memset(out, 0xFF, size);
+        if (file_ == nullptr)
+            return;
+
+        std::fseek(file_, static_cast<long>(offset), SEEK_SET);
+        std::size_t const count = std::fread(out, 1u, size, file_);
+        static_cast<void>(count);
+    }
+
+    bool data_flash_t::write(uint32_t offset, void const *data, std::size_t size) noexcept
+    {
+        if (file_ == nullptr || offset + size > data_flash_size)
+            return false;
+
+        // Programming only clears bits, like the real thing.
+        std::array<uint8_t, data_flash_block_size> current;
+        uint8_t const *in = static_cast<uint8_t const*>(data);
+        while (size != 0u)
+        {
+            std::size_t const count = std::min(size, current.size());
+            read(offset, current.data(), count);
+            for (std::size_t i = 0; i != count; ++i)
+                current[i] &= in[i];
+
+            std::fseek(file_, static_cast<long>(offset), SEEK_SET);
+            if (std::fwrite(current.data(), 1u, count, file_) != count)
+                return false;
+
+            offset += count;
+            in += count;
+            size -= count;
+        }
+        return std::fflush(file_) == 0;
+    }
+
+    bool data_flash_t::erase(std::size_t block) noexcept
+    {
+        if (file_ == nullptr || block >= data_flash_blocks)
+            return false;
+
+        std::array<uint8_t, data_flash_block_size> erased;
+        erased.fill(0xFFu);
+        std::fseek(file_, static_cast<long>(block * data_flash_block_size), SEEK_SET);
+        bool const written = std::fwrite(erased.data(), 1u, erased.size(), file_) == erased.size();
+        return written && std::fflush(file_) == 0;
+    }
+}
+
+#endif
@@ -19,152 +19,292 @@
 #include <algorithm>
 
 #include "display.hpp"
+#include "number_format.hpp"
 
 namespace
 {
     io::display_t *instance = nullptr;
 
-    // 40 characters.
-    TEXT_ANIMATION_DEFINE(anim, 200)
+    struct dashboard_number_t
+    {
+        char digits[4] = "^^^";
+        int point = -1;     /**< Index of the digit the decimal point follows, if any. */
+    };
+
+    /**
+    * Fits a reading with implied decimals into the dashboard's three digits, dropping the decimals that do not fit.
+    * A whole part of more than three digits does not fit at all and shows as "^^^".
+    */
+    dashboard_number_t dashboard_number(uint16_t value, uint8_t decimals) noexcept
+    {
+        auto power_of_ten = [](int n)
+        {
+            uint32_t p = 1u;
+            while (n-- > 0)
+                p *= 10u;
+            return p;
+        };
+
+        int whole_digits = 1;
+        for (uint32_t whole = value / power_of_ten(decimals); whole >= 10u; whole /= 10u)
+            ++whole_digits;
+
+        dashboard_number_t number;
+        if (whole_digits > 3)
+            return number;
+
+        // As many decimals as fit after the whole part, the rest are cut off.
+        int const shown = std::min<int>(decimals, 3 - whole_digits);
+        uint32_t scaled = value / power_of_ten(decimals - shown);
+        for (int i = 2; i >= 0; --i)
+        {
+            number.digits[i] = (scaled != 0u || i >= 2 - shown) ? static_cast<char>('0' + scaled % 10u) : ' ';
+            scaled /= 10u;
+        }
+        if (shown != 0)
+            number.point = 2 - shown;
+        return number;
+    }
 }
 
     
 namespace io
 {
     display_t::display_t() noexcept
-    : next_(true), toggle_msg_(0u)
+    : next_(true), frequency_(0u), running_(false), dirty_(true), fault_shown_(false)
     {
         if (::instance == nullptr)
             ::instance = this;
     }
 
-    bool display_t::begin() noexcept
+    bool display_t::begin(chrono::time_point_t now) noexcept
     {
+        // Messages queued before the first update are stamped with this, not the clock's epoch.
+        now_ = now;
         return matrix_.begin();
     }
 
+    void display_t::configure(display_args_t args) noexcept
+    {
+        args_ = args;
+        dirty_ = true;
+    }
+
     void display_t::update(chrono::time_point_t now) noexcept
     {
+        now_ = now;
         if ((now > next_timeout_) && !next_)
             next_ = true;
 
         if (!next_)
             return;
 
-        if (!has_msg())
-            return;
-
-        next(now);
+        if (auto msg = queue_.pop(now))
+            next(*msg, now);
+        else if (args_.mode == display_mode_t::dashboard)
+            show_dashboard(now);
     }
    
-    void display_t::set(modbus_error_t err) noexcept
+    void display_t::set(modbus_error_t err, severity_t severity) noexcept
     {
-        auto itr = std::find(errors_.begin(), errors_.end(), err);
-        if (itr == errors_.end() && errors_.size() < errors_.capacity())
-        {
-            errors_.push(err);
-        }
+        queue_.push(display_msg_t{ display_msg_t::kind_t::error, severity, err }, now_);
     }
 
     void display_t::set(value_msg_t msg) noexcept
     {
-        auto itr = std::find_if(values_.begin(), values_.end(), [&](value_msg_t const &m)
-        {
-            return m.id.address == msg.id.address;
-        });
-        if (itr != values_.end())
-        {
-            *itr = msg;
-        }
-        else if (values_.size() < values_.capacity())
-        {
-            values_.push(msg);
-        }
+        update_dashboard(msg);
+        if (args_.mode == display_mode_t::dashboard)
+            return;
+
+        queue_.push(display_msg_t{ display_msg_t::kind_t::value, severity_t::reading, modbus_error_t::success, msg },
+            now_);
     }
 
-    void display_t::set(std::string_view msg) noexcept
+    void display_t::set(std::string_view msg, severity_t severity) noexcept
     {
-        auto itr = std::find(failures_.begin(), failures_.end(), msg);
-        if (itr == failures_.end() && failures_.size() < failures_.capacity())
-        {
-            failures_.push(msg);
-        }
+        queue_.push(display_msg_t{ display_msg_t::kind_t::text, severity, modbus_error_t::success, value_msg_t{},
+            display_text_t{ msg.data(), msg.size() } }, now_);
     }
 
-    void display_t::next(chrono::time_point_t now) noexcept
+    void display_t::next(display_msg_t const &msg, chrono::time_point_t now) noexcept
     {
         next_ = false;
 
         constexpr uint32_t milliseconds_per_frame = 100u;
 
-        matrix_.beginDraw();
-        matrix_.stroke(0xFFFFFFFF);
-        matrix_.textFont(Font_5x7);
-        matrix_.textScrollSpeed(milliseconds_per_frame);
-        matrix_.setCallback([]()
+        display_text_t text;
+        format(msg, text);
+
+        // Scrolling the same message again replays its cached frames instead of rendering the text one frame at
+        // a time.  A miss renders straight into the cache.
+        std::string_view const key{ text.data(), text.size() };
+        auto cached = cache_.find(key);
+        if (!cached)
+        {
+            // One frame per column scrolled, println's "\r\n" included, for as much text as the canvas keeps.
+            std::size_t const glyphs = std::min<std::size_t>(text.size() + 2u, ARDUINOGRAPHICS_TEXT_CAPACITY);
+            uint32_t const frames = static_cast<uint32_t>(glyphs) * Font_5x7.width;
+            frame_cache_t::entry_t space = cache_.reserve(key, frames);
+            uint32_t const used = canvas_.render(text.c_str(), Font_5x7, milliseconds_per_frame, space.frames,
+                space.bytes);
+            cached = cache_.commit(used);
+            if (!cached)
+                return;
+        }
+        // The matrix reads the frames from the cache as it plays them, so they must stay put until it is done.
+        cache_.set_playing(cached->frames);
+        matrix_.play(cached->frames, cached->bytes, []()
         {
+            ::instance->cache_.set_playing(nullptr);
             ::instance->next_ = true;
         });
-  
-        matrix_.beginText(0, 1, 0xFFFFFF);
-        print_next_msg(matrix_);
-        matrix_.endTextAnimation(SCROLL_LEFT, anim);
-  
-        matrix_.loadTextAnimationSequence(anim);
-        matrix_.play();
-
-        uint32_t const frame_count = (anim_buf_used / 4) / sizeof(uint32_t);
+
+        uint32_t const frame_count = cached->bytes / sizeof(frame_t);
         uint32_t const milliseconds_trip = (frame_count + 2u) * milliseconds_per_frame;
         next_timeout_ = now + std::chrono::milliseconds{ milliseconds_trip };
+
+        // In dashboard mode only errors scroll; keep the fault indicator lit for a while after each fault (not after
+        // warnings), and put the dashboard back once the scroll is done.
+        constexpr chrono::duration_t fault_hold = std::chrono::minutes(1u);
+        if (msg.severity == severity_t::fault)
+            fault_until_ = next_timeout_ + fault_hold;
+        dirty_ = true;
     }
 
-    bool display_t::has_msg() noexcept
+    void display_t::update_dashboard(value_msg_t msg) noexcept
     {
-        if (!errors_.empty())
-            return true;
-
-        if (!values_.empty())
-            return true;
-
-        if (!failures_.empty())
-            return true;
-        
-        return false;
+        if (msg.msg == LOG_MSG("pressure: "))
+        {
+            uint16_t const pressure = static_cast<uint16_t>(std::min<uint64_t>(msg.value, UINT16_MAX));
+            dirty_ = dirty_ || pressure_ != pressure;
+            pressure_ = pressure;
+        }
+        else if (msg.msg == LOG_MSG("frequency: "))
+        {
+            dirty_ = dirty_ || frequency_ != msg.value;
+            frequency_ = static_cast<uint16_t>(msg.value);
+        }
+        else if (msg.msg == LOG_MSG("run: "))
+        {
+            bool const running = msg.value == args_.run;
+            dirty_ = dirty_ || running_ != running;
+            running_ = running;
+        }
     }
 
-    constexpr uint16_t num_msg_categories = 3u;
-    void display_t::print_next_msg(ArduinoLEDMatrix &matrix) noexcept
+    /**
+    * Rows 0-5: pressure in three 4x6 digits, with its decimal point a single pixel in the gap after a digit.
+    * Rows 6-7: frequency bar over columns 0-8 while running, fault indicator in columns 10-11.  Drawn as a single
+    * frame, so a change is visible on the next update.
+    */
+    void display_t::show_dashboard(chrono::time_point_t now) noexcept
     {
-        ++toggle_msg_;
-        for (uint16_t i = 0; i != num_msg_categories; ++i, ++toggle_msg_)
+        bool const fault = now < fault_until_;
+        if (!dirty_ && fault == fault_shown_)
+            return;
+
+        dashboard_number_t pressure{ "---" };
+        if (pressure_)
+            pressure = dashboard_number(*pressure_, args_.pressure_decimals);
+
+        constexpr int bar_columns = 9;
+        int bar = 0;
+        if (running_ && args_.full_scale_frequency != 0u)
+        {
+            uint32_t const scaled = (static_cast<uint32_t>(frequency_) * bar_columns + args_.full_scale_frequency - 1u) /
+                args_.full_scale_frequency;
+            bar = static_cast<int>(std::clamp<uint32_t>(scaled, 1u, bar_columns));
+        }
+
+        canvas_.beginDraw();
+        canvas_.stroke(0xFFFFFFFF);
+        canvas_.textFont(Font_4x6);
+        canvas_.text(pressure.digits, 0, 0);
+        if (pressure.point >= 0)
+            canvas_.set(pressure.point * 4 + 3, 4, 0xFFFFFFFF);
+        for (int x = 0; x != bar; ++x)
         {
-            uint16_t const option = toggle_msg_ % num_msg_categories;
-            if (option == 0u && !errors_.empty())
+            canvas_.set(x, 6, 0xFFFFFFFF);
+            canvas_.set(x, 7, 0xFFFFFFFF);
+        }
+        if (fault)
+        {
+            for (int x = 10; x != 12; ++x)
             {
-                modbus_error_t err = errors_.front();
-                errors_.pop();
-                auto msg = error_message(err);
-                matrix.print("  ");
-                matrix.println(msg.data());
-                return;
+                canvas_.set(x, 6, 0xFFFFFFFF);
+                canvas_.set(x, 7, 0xFFFFFFFF);
             }
-            if (option == 1u && !values_.empty())
+        }
+        canvas_.endDraw();
+
+        // A still frame takes the place of any animation still playing.
+        matrix_.show(canvas_.pixels());
+        cache_.set_playing(nullptr);
+        dirty_ = false;
+        fault_shown_ = fault;
+    }
+
+    void display_t::format(display_msg_t const &msg, display_text_t &text) noexcept
+    {
+        text.assign("  ");
+        switch (msg.kind)
+        {
+            case display_msg_t::kind_t::error:
             {
-                value_msg_t vm = values_.front();
-                values_.pop();
-                matrix.print("  ");
-                matrix.print(vm.msg.data());
-                matrix.println(vm.value);
-                return;
+                auto str = error_message(msg.error);
+                text.append(str.data(), str.size());
+                break;
             }
-            if (option == 2u && !failures_.empty())
+            case display_msg_t::kind_t::value:
             {
-                std::string_view msg = failures_.front();
-                failures_.pop();
-                matrix.print("  ");
-                matrix.println(msg.data());
-                return;
+                auto str = message_text(msg.value.msg);
+                text.append(str.data(), str.size());
+
+                uint8_t decimals = 0u;
+                if (msg.value.msg == LOG_MSG("pressure: "))
+                    decimals = args_.pressure_decimals;
+                else if (msg.value.msg == LOG_MSG("frequency: "))
+                    decimals = args_.frequency_decimals;
+
+                char digits[max_number_chars];
+                char const *end = format_fixed(digits, digits + sizeof(digits), msg.value.value, decimals);
+                text.append(digits, static_cast<std::size_t>(end - digits));
+                break;
             }
+            case display_msg_t::kind_t::text:
+                text.append(msg.text.data(), msg.text.size());
+                break;
         }
     }
-}
\ No newline at end of file
+
+    void display_t::dump_stats(Print &out) const noexcept
+    {
+        char buffer[96];
+        frame_cache_stats_t const &s = cache_.stats();
+        text_writer_t line(buffer, sizeof(buffer));
+        line.append("frame cache: hits=").append(s.hits)
+            .append(" misses=").append(s.misses)
+            .append(" evictions=").append(s.evictions);
+        out.println(line.c_str());
+
+        message_queue_stats_t const &q = queue_.stats();
+        line.clear();
+        line.append("display queue: queued=").append(q.queued)
+            .append(" coalesced=").append(q.coalesced)
+            .append(" expired=").append(q.expired)
+            .append(" dropped=").append(q.dropped);
+        out.println(line.c_str());
+
+        constexpr char const *severity_names[num_severities] = { "reading", "warning", "fault" };
+        for (std::size_t i = 0u; i != num_severities; ++i)
+        {
+            message_latency_t const &l = q.latency[i];
+            line.clear();
+            line.append("  ").append(severity_names[i])
+                .append(": shown=").append(l.shown)
+                .append(" mean_ms=").append(l.mean_ms())
+                .append(" max_ms=").append(l.max_ms);
+            out.println(line.c_str());
+        }
+    }
+}
@@ -36,6 +36,7 @@ namespace chrono
             return false;
 
         queue_.push(event);
+        return true;
     }
 
     template <class T>
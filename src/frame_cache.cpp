@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "frame_cache.hpp"
+
+namespace io
+{
+    frame_cache_t::frame_cache_t() noexcept
+    : tick_(0u), playing_(nullptr)
+    {}
+
+    std::optional<frame_cache_t::entry_t> frame_cache_t::find(std::string_view text) noexcept
+    {
+        auto itr = std::find_if(slots_.begin(), slots_.end(), [&](slot_t const &slot)
+        {
+            return std::string_view{ slot.text.data(), slot.text.size() } == text;
+        });
+
+        if (itr == slots_.end())
+        {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+
+        ++stats_.hits;
+        itr->last_used = ++tick_;
+        return entry(*itr);
+    }
+
+    /**
+    * Makes room for an animation of up to 'frames' frames at the end of the pool, evicting the least recently used
+    * entries as needed.  Animations longer than the space that can be freed are cut short, as they would be by any
+    * fixed buffer: the whole pool, or what is left after the entry that is playing.  The space belongs to 'text' once
+    * the number of bytes actually rendered is committed.
+    */
+    frame_cache_t::entry_t frame_cache_t::reserve(std::string_view text, uint32_t frames) noexcept
+    {
+        uint32_t count = std::min(frames, frame_cache_frames);
+        while (slots_.full() || frame_cache_frames - end() < count)
+        {
+            if (!evict())
+                break;
+        }
+        count = std::min(count, frame_cache_frames - end());
+
+        slot_t slot;
+        slot.text.assign(text.data(), std::min(text.size(), max_display_text));
+        slot.first = static_cast<uint16_t>(end());
+        slot.count = static_cast<uint16_t>(count);
+        slot.last_used = ++tick_;
+        slots_.push_back(slot);
+        return entry(slots_.back());
+    }
+
+    std::optional<frame_cache_t::entry_t> frame_cache_t::commit(uint32_t bytes) noexcept
+    {
+        slot_t &slot = slots_.back();
+        slot.count = static_cast<uint16_t>(std::min<uint32_t>(slot.count, bytes / sizeof(frame_t)));
+        if (slot.count == 0u)
+        {
+            slots_.pop_back();
+            return std::nullopt;
+        }
+        return entry(slot);
+    }
+
+    uint32_t frame_cache_t::end() const noexcept
+    {
+        return slots_.empty() ? 0u : slots_.back().first + slots_.back().count;
+    }
+
+    frame_cache_t::entry_t frame_cache_t::entry(slot_t const &slot) noexcept
+    {
+        return entry_t{ frames_ + slot.first, static_cast<uint32_t>(slot.count * sizeof(frame_t)) };
+    }
+
+    /**
+    * Evicts the least recently used entry other than the one playing, if there is one.  The entries after it are
+    * packed down behind the entry before it, unless that would move the one playing.
+    */
+    bool frame_cache_t::evict() noexcept
+    {
+        auto const playing = std::find_if(slots_.begin(), slots_.end(), [&](slot_t const &slot)
+        {
+            return frames_ + slot.first == playing_;
+        });
+
+        auto victim = slots_.end();
+        for (auto itr = slots_.begin(); itr != slots_.end(); ++itr)
+        {
+            if (itr != playing && (victim == slots_.end() || itr->last_used < victim->last_used))
+                victim = itr;
+        }
+        if (victim == slots_.end())
+            return false;
+
+        ++stats_.evictions;
+        if (playing != slots_.end() && playing > victim)
+        {
+            slots_.erase(victim);
+            return true;
+        }
+
+        uint32_t next = victim == slots_.begin() ? 0u : (victim - 1)->first + (victim - 1)->count;
+        for (auto itr = slots_.erase(victim); itr != slots_.end(); ++itr)
+        {
+            std::memmove(frames_ + next, frames_ + itr->first, itr->count * sizeof(frame_t));
+            itr->first = static_cast<uint16_t>(next);
+            next += itr->count;
+        }
+        return true;
+    }
+}
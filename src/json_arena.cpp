@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "json_arena.hpp"
+
+namespace
+{
+    // Every block is preceded by its size, and both are kept aligned for anything ArduinoJson stores.
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    constexpr std::size_t header_size = alignment;
+
+    constexpr std::size_t align(std::size_t size) noexcept
+    {
+        return (size + alignment - 1u) & ~(alignment - 1u);
+    }
+
+    static_assert(sizeof(std::size_t) <= header_size, "block size does not fit its header");
+}
+
+namespace io
+{
+    json_arena_t::json_arena_t(void *buffer, std::size_t size) noexcept
+    : buffer_(static_cast<uint8_t*>(buffer)), size_(size), used_(0u), last_(size), peak_(0u), failures_(0u)
+    {}
+
+    void* json_arena_t::allocate(std::size_t size)
+    {
+        // Sizes are checked before rounding up, which would wrap for the largest of them.
+        std::size_t const block = align(size);
+        if (size > size_ || block > size_ || header_size + block > size_ - used_)
+        {
+            ++failures_;
+            return nullptr;
+        }
+
+        std::memcpy(buffer_ + used_, &block, sizeof(block));
+        last_ = used_;
+        set_used(used_ + header_size + block);
+        return buffer_ + last_ + header_size;
+    }
+
+    void json_arena_t::deallocate(void *ptr)
+    {
+        if (ptr != nullptr && last(ptr))
+        {
+            set_used(last_);
+            last_ = size_;
+        }
+    }
+
+    void* json_arena_t::reallocate(void *ptr, std::size_t size)
+    {
+        if (ptr == nullptr)
+            return allocate(size);
+
+        std::size_t const old_block = block_size(ptr);
+        std::size_t const block = align(size);
+        if (last(ptr))
+        {
+            if (size > size_ || block > size_ - last_ - header_size)
+            {
+                ++failures_;
+                return nullptr;
+            }
+
+            std::memcpy(buffer_ + last_, &block, sizeof(block));
+            set_used(last_ + header_size + block);
+            return ptr;
+        }
+
+        if (size <= old_block)
+            return ptr;
+
+        void *moved = allocate(size);
+        if (moved != nullptr)
+            std::memcpy(moved, ptr, old_block);
+        return moved;
+    }
+
+    void json_arena_t::reset() noexcept
+    {
+        used_ = 0u;
+        last_ = size_;
+        peak_ = 0u;
+        failures_ = 0u;
+    }
+
+    bool json_arena_t::last(void const *ptr) const noexcept
+    {
+        return last_ != size_ && ptr == buffer_ + last_ + header_size;
+    }
+
+    std::size_t json_arena_t::block_size(void const *ptr) const noexcept
+    {
+        std::size_t size;
+        std::memcpy(&size, static_cast<uint8_t const*>(ptr) - header_size, sizeof(size));
+        return size;
+    }
+
+    void json_arena_t::set_used(std::size_t used) noexcept
+    {
+        used_ = used;
+        if (used_ > peak_)
+            peak_ = used_;
+    }
+}
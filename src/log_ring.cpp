@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "log_ring.hpp"
+
+namespace io
+{
+    log_ring_t::log_ring_t() noexcept
+    : head_(0u), size_(0u), pending_(0u), overflow_(false)
+    {}
+
+    void log_ring_t::begin_record() noexcept
+    {
+        pending_ = 0u;
+        overflow_ = false;
+    }
+
+    bool log_ring_t::end_record() noexcept
+    {
+        if (overflow_)
+        {
+            pending_ = 0u;
+            overflow_ = false;
+            ++stats_.dropped;
+            return false;
+        }
+
+        size_ += pending_;
+        pending_ = 0u;
+        ++stats_.records;
+        stats_.high_water = std::max<uint32_t>(stats_.high_water, size_);
+        return true;
+    }
+
+    size_t log_ring_t::write(uint8_t b)
+    {
+        if (overflow_ || size_ + pending_ == buffer_.size())
+        {
+            overflow_ = true;
+            return 0u;
+        }
+
+        buffer_[(head_ + size_ + pending_) % buffer_.size()] = b;
+        ++pending_;
+        return 1u;
+    }
+
+    size_t log_ring_t::write(uint8_t const *data, size_t count)
+    {
+        if (overflow_ || size_ + pending_ + count > buffer_.size())
+        {
+            overflow_ = true;
+            return 0u;
+        }
+
+        std::size_t const tail = (head_ + size_ + pending_) % buffer_.size();
+        std::size_t const first = std::min(count, buffer_.size() - tail);
+        std::copy_n(data, first, buffer_.data() + tail);
+        std::copy_n(data + first, count - first, buffer_.data());
+        pending_ += count;
+        return count;
+    }
+
+    std::size_t log_ring_t::contiguous() const noexcept
+    {
+        return std::min(size_, buffer_.size() - head_);
+    }
+
+    void log_ring_t::consume(std::size_t count) noexcept
+    {
+        count = std::min(count, size_);
+        head_ = (head_ + count) % buffer_.size();
+        size_ -= count;
+    }
+}
@@ -16,59 +16,557 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+
 #include "logging.hpp"
+#include "number_format.hpp"
+
+namespace
+{
+    constexpr std::array<uint8_t, io::sector_size> zero_sector{};
+
+    using segment_name_t = std::array<char, 13u>;
+
+    segment_name_t segment_name(std::string_view base, uint8_t index) noexcept
+    {
+        // 8.3 name: the base, then the segment index as a three digit extension.
+        segment_name_t name{};
+        std::size_t const length = std::min(base.size(), std::size_t{ 8u });
+        std::copy_n(base.begin(), length, name.begin());
+        name[length] = '.';
+        name[length + 1u] = static_cast<char>('0' + index / 100u);
+        name[length + 2u] = static_cast<char>('0' + (index / 10u) % 10u);
+        name[length + 3u] = static_cast<char>('0' + index % 10u);
+        return name;
+    }
+
+    std::optional<uint32_t> read_segment_sequence(File &file) noexcept
+    {
+        std::array<uint8_t, io::record_header_size + 2u * io::max_varint_size + io::record_trailer_size> header{};
+        int const count = file.read(header.data(), header.size());
+        if (count <= 0 || header[0] != static_cast<uint8_t>(io::record_t::segment) || !io::record_intact(header.data(), count))
+            return std::nullopt;
+
+        io::record_reader_t reader{ header.data() + io::record_header_size, header[1] };
+        reader.get();
+        uint64_t const sequence = reader.get();
+        if (reader.error())
+            return std::nullopt;
+
+        return static_cast<uint32_t>(sequence);
+    }
+
+    constexpr bool urgent(io::record_t type) noexcept
+    {
+        // Faults are what matter most after a brown out, so they are written out and flushed without waiting.
+        switch (type)
+        {
+            case io::record_t::modbus_error:
+            case io::record_t::failure:
+            case io::record_t::failure_text:
+            case io::record_t::repeated:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    struct log_tail_t
+    {
+        uint32_t end = 0u;
+        std::optional<uint8_t> sequence;    /**< Sequence number of the last intact record. */
+    };
+
+    log_tail_t recover_log_tail(File &file) noexcept
+    {
+        // Sectors are filled front to back and each one in use starts with a record, so a binary search for the first
+        // sector starting with a zero byte finds the end of the log.  Only the tail is read, however long the log.
+        uint32_t const size = file.size();
+        uint32_t first = 0u;
+        uint32_t last = (size + io::sector_size - 1u) / io::sector_size;
+        while (first != last)
+        {
+            uint32_t const mid = first + (last - first) / 2u;
+            file.seek(mid * io::sector_size);
+            if (file.read() > 0)
+                first = mid + 1u;
+            else
+                last = mid;
+        }
+
+        std::array<uint8_t, io::sector_size> sector;
+        for (; first != 0u; --first)
+        {
+            uint32_t const start = (first - 1u) * io::sector_size;
+            file.seek(start);
+            int const read = file.read(sector.data(), sector.size());
+            std::size_t const count = read > 0 ? static_cast<std::size_t>(read) : 0u;
+
+            // Keep the run of intact, consecutively numbered records at the start of the sector.  A torn write ends it.
+            std::size_t offset = 0u;
+            std::optional<uint8_t> sequence;
+            while (offset != count && io::record_intact(sector.data() + offset, count - offset))
+            {
+                uint8_t const next = sector[offset + 2u];
+                if (sequence && next != static_cast<uint8_t>(*sequence + 1u))
+                    break;
+
+                sequence = next;
+                offset += io::record_size(sector[offset + 1u]);
+            }
+
+            // Zero the torn tail, so it is neither resumed after nor mistaken for records later.
+            bool const torn = std::any_of(sector.begin() + offset, sector.begin() + count, [](uint8_t b) { return b != 0u; });
+            if (torn)
+            {
+                file.seek(start + offset);
+                file.write(zero_sector.data(), count - offset);
+                file.flush();
+            }
+
+            // A sector with nothing intact left in it falls back to the one before.
+            if (sequence)
+                return log_tail_t{ static_cast<uint32_t>(start + offset), sequence };
+        }
+        return log_tail_t{};
+    }
+}
 
 namespace io
 {
 
-    logger_t::logger_t(display_t &dsply) noexcept
-    : display_(dsply)
+    logger_t::logger_t(display_t &dsply, chrono::monotonic_clock_t &clock) noexcept
+    : display_(dsply), clock_(clock), file_offset_(0u), segment_end_(0u), segment_(0u), segment_index_(0u),
+      growing_(false), next_size_(0u), prealloc_offset_(0u), next_index_(0u), append_offset_(0u), append_end_(0u),
+      append_segment_(0u), sequence_(0u), urgent_(false), sync_(false), level_(min_log_level), session_(false), last_record_ms_(0),
+      pending_record_ms_(0)
     {}
 
-    void logger_t::begin_log(std::string_view file) noexcept
+    void logger_t::begin_log(std::string_view base) noexcept
     {
-        file_ = SD.open(file.data(), FILE_WRITE);
+        base_ = base;
+
+        // Resume the segment with the highest sequence number, or start at segment zero on an empty card.
+        std::optional<uint32_t> latest;
+        segment_index_ = 0u;
+        for (uint8_t i = 0u; i != max_log_segments; ++i)
+        {
+            segment_name_t const name = segment_name(base_, i);
+            if (!SD.exists(name.data()))
+                continue;
+
+            File file = SD.open(name.data());
+            std::optional<uint32_t> const sequence = read_segment_sequence(file);
+            file.close();
+            if (sequence && (!latest || *sequence > *latest))
+            {
+                latest = sequence;
+                segment_index_ = i;
+            }
+        }
+
+        // The file is written at a tracked offset rather than appended to, so preallocated space is overwritten.
+        file_ = SD.open(segment_name(base_, segment_index_).data(), O_READ | O_WRITE | O_CREAT);
+        if (!file_)
+            return;
+
+        uint32_t const size = file_.size();
+        segment_ = latest.value_or(0u);
+        log_tail_t const tail = latest ? recover_log_tail(file_) : log_tail_t{};
+        file_offset_ = tail.end;
+        sequence_ = tail.sequence ? static_cast<uint8_t>(*tail.sequence + 1u) : 0u;
+        segment_end_ = std::max<uint32_t>(size - size % sector_size, rotation_.segment_size);
+        growing_ = size < rotation_.segment_size;
+        file_.seek(file_offset_);
+
+        append_offset_ = file_offset_;
+        append_end_ = segment_end_;
+        append_segment_ = segment_;
+        next_size_ = rotation_.segment_size;
+        prealloc_offset_ = 0u;
     }
 
-    void logger_t::log(modbus_error_t err) noexcept
+    void logger_t::set_rotation(log_rotation_t rotation) noexcept
     {
-        display_.set(err);
-        switch (err)
+        rotation_.segments = std::clamp(rotation.segments, uint8_t{ 2u }, max_log_segments);
+        rotation_.segment_size = std::max<uint32_t>(rotation.segment_size - rotation.segment_size % sector_size, min_segment_size);
+
+        // A segment that was not preallocated can still take on the new size.
+        if (growing_ && append_segment_ == segment_)
         {
-            case modbus_error_t::slave_device_failure:
-            case modbus_error_t::invalid_slave_id:
-            file_.println(error_message(err).data());
-            break;
+            uint32_t const used = (append_offset_ + sector_size - 1u) / sector_size * sector_size;
+            segment_end_ = std::max(rotation_.segment_size, used);
+            append_end_ = segment_end_;
         }
+
+        // Start the next segment over, so it gets the new size and index.
+        next_.close();
+        next_ = File{};
+        prealloc_offset_ = 0u;
+        if (append_segment_ == segment_)
+            next_size_ = rotation_.segment_size;
+    }
+
+    void logger_t::set_level(level_t level) noexcept
+    {
+        level_ = level;
+    }
+
+    void logger_t::set_repeat_window(chrono::duration_t window) noexcept
+    {
+        repeats_.set_window(window);
+    }
+
+    void logger_t::write(modbus_error_t err, log_site_t site) noexcept
+    {
+        int64_t const now = chrono::to_monotonic(clock_.now()).milliseconds;
+        bool const first = repeats_.pass(err, site, now, [this](repeat_summary_t const &summary)
+        {
+            write(summary);
+        });
+
+        if (!first)
+            return;
+
+        record_writer_t record = make_record(record_t::modbus_error);
+        record.put(static_cast<uint8_t>(err));
+        record.put(site.line);
+        commit(record);
+    }
+
+    void logger_t::write(repeat_summary_t const &summary) noexcept
+    {
+        record_writer_t record = make_record(record_t::repeated);
+        record.put(static_cast<uint8_t>(summary.error));
+        record.put(summary.site.line);
+        record.put(summary.count);
+        record.put(static_cast<uint64_t>(summary.duration_ms));
+        commit(record);
+    }
+
+    void logger_t::write(value_msg_t vm) noexcept
+    {
+        if (!value_changed(vm))
+            return;
+
+        record_writer_t record = make_record(record_t::value);
+        record.put(static_cast<uint8_t>(vm.msg));
+        record.put(vm.id.address);
+        record.put(vm.value);
+        commit(record);
+    }
+
+    void logger_t::write(msg_id_t msg) noexcept
+    {
+        record_writer_t record = make_record(record_t::message);
+        record.put(static_cast<uint8_t>(msg));
+        commit(record);
+    }
+
+    void logger_t::write(msg_id_t msg, std::uint32_t value) noexcept
+    {
+        record_writer_t record = make_record(record_t::message_value);
+        record.put(static_cast<uint8_t>(msg));
+        record.put(value);
+        commit(record);
+    }
+
+    void logger_t::write(std::string_view msg) noexcept
+    {
+        record_writer_t record = make_record(record_t::text);
+        record.put_bytes(reinterpret_cast<uint8_t const*>(msg.data()), msg.size());
+        commit(record);
+    }
+
+    void logger_t::write(chrono::profiler_t const &profiler) noexcept
+    {
+        for (std::size_t i = 0; i != chrono::num_scopes; ++i)
+        {
+            chrono::scope_stats_t const &stats = profiler.stats(static_cast<chrono::scope_t>(i));
+            record_writer_t record = make_record(record_t::profile);
+            record.put(i);
+            record.put(stats.count);
+            record.put(stats.count == 0u ? 0u : stats.min);
+            record.put(stats.mean());
+            record.put(stats.max);
+            for (uint32_t bucket : stats.histogram)
+                record.put(bucket);
+            commit(record);
+        }
+
+        log_ring_stats_t const &ring_stats = ring_.stats();
+        record_writer_t record = make_record(record_t::log_stats);
+        record.put(ring_stats.records);
+        record.put(ring_stats.high_water);
+        record.put(ring_stats.dropped);
+        commit(record);
+    }
+
+    void logger_t::write_failure(msg_id_t msg) noexcept
+    {
+        record_writer_t record = make_record(record_t::failure);
+        record.put(static_cast<uint8_t>(msg));
+        commit(record);
+    }
+
+    void logger_t::write_failure(std::string_view msg) noexcept
+    {
+        record_writer_t record = make_record(record_t::failure_text);
+        record.put_bytes(reinterpret_cast<uint8_t const*>(msg.data()), msg.size());
+        commit(record);
     }
 
-    void logger_t::log(value_msg_t vm) noexcept
+    void logger_t::show(msg_id_t msg, std::uint32_t value, severity_t severity) noexcept
     {
-        display_.set(vm);
+        char buffer[max_display_text + 1u];
+        text_writer_t text(buffer, sizeof(buffer));
+        text.append(message_text(msg)).append(value);
+        display_.set(text.view(), severity);
+    }
+
+    void logger_t::update(chrono::time_point_t now) noexcept
+    {
+        repeats_.expire(chrono::to_monotonic(now).milliseconds, [this](repeat_summary_t const &summary)
+        {
+            write(summary);
+        });
+
+        // The flush after a stale write out gets a call to itself, so no call pays for both.
+        if (sync_)
+        {
+            sync_ = false;
+            file_.flush();
+            return;
+        }
+
+        // Idle calls zero fill a sector of the next segment instead.
+        if (ring_.empty())
+        {
+            preallocate();
+            return;
+        }
+
+        // Write at most one chunk per call, so a call never costs more than a single sector write.
+        std::size_t const boundary = to_sector_boundary();
+        bool const full_sector = ring_.size() >= boundary;
+        bool const stale = urgent_ || !oldest_ || (now - *oldest_) >= log_max_age;
+        if (!full_sector && !stale)
+        {
+            preallocate();
+            return;
+        }
+
+        write_out(std::min(ring_.contiguous(), boundary));
+        if (ring_.empty())
+        {
+            oldest_.reset();
+            if (stale)
+            {
+                sync_ = true;
+                urgent_ = false;
+            }
+        }
     }
 
-    void logger_t::log(std::string_view msg) noexcept
+    void logger_t::preallocate() noexcept
     {
-        file_.println(msg.data());
+        if (!file_ || prealloc_offset_ >= next_size_)
+            return;
+
+        if (!next_)
+        {
+            open_next();
+            return;
+        }
+
+        next_.write(zero_sector.data(), zero_sector.size());
+        prealloc_offset_ += sector_size;
+        if (prealloc_offset_ >= next_size_)
+            next_.flush();
     }
 
-    void logger_t::log(std::string_view msg, std::uint32_t value) noexcept
+    void logger_t::open_next() noexcept
     {
-        file_.print(msg.data());
-        file_.println(value);
+        // Recreate the file so its clusters are allocated in one run while it is zero filled, and nothing left over
+        // from the segment it replaces can be mistaken for records.
+        next_index_ = (segment_index_ + 1u) % rotation_.segments;
+        segment_name_t const name = segment_name(base_, next_index_);
+        SD.remove(name.data());
+        next_ = SD.open(name.data(), O_READ | O_WRITE | O_CREAT);
+
+        // If the card will not take another file there is no point retrying every update; rotate() tries once more.
+        prealloc_offset_ = next_ ? 0u : next_size_;
     }
 
-    void logger_t::log_on_failure(bool passed, std::string_view msg) noexcept
+    void logger_t::rotate() noexcept
     {
-        if (!passed)
+        int64_t const start = chrono::profiler_micros();
+
+        if (!next_)
+            open_next();
+
+        if (next_)
         {
-            display_.set(msg);
-            file_.println(msg.data());
+            // Normally the next segment was zero filled in the background already.  If logging outran that, it is
+            // taken as far as it got and grows as it is written, rather than finishing the fill here and stalling.
+            file_.close();
+            file_ = next_;
+            file_.seek(0u);
+            next_ = File{};
+            file_offset_ = 0u;
+            segment_end_ = next_size_;
+            segment_index_ = next_index_;
+            growing_ = prealloc_offset_ < next_size_;
         }
+        else
+        {
+            // The card will not take the next segment.  Rather than lose the log, carry on past the end of this one,
+            // which grows by a segment, and try again from there.  Its end no longer follows the rotation size.
+            segment_end_ += next_size_;
+            growing_ = false;
+        }
+        ++segment_;
+
+        prealloc_offset_ = 0u;
+        if (append_segment_ == segment_)
+            next_size_ = rotation_.segment_size;
+
+        log(LOG_MSG("log rollover us: "), chrono::to_profile_micros(chrono::profiler_micros() - start));
     }
 
     void logger_t::flush() noexcept
     {
+        while (!ring_.empty())
+            write_out(std::min(ring_.contiguous(), to_sector_boundary()));
+
+        oldest_.reset();
         file_.flush();
+        urgent_ = false;
+        sync_ = false;
+    }
+
+    void logger_t::dump_stats(Print &out) const noexcept
+    {
+        char buffer[64];
+        log_ring_stats_t const &s = ring_.stats();
+        text_writer_t line(buffer, sizeof(buffer));
+        line.append("log ring: records=").append(s.records)
+            .append(" high_water=").append(s.high_water)
+            .append(" dropped=").append(s.dropped);
+        out.println(line.c_str());
+    }
+
+    record_writer_t logger_t::make_record(record_t type) noexcept
+    {
+        int64_t const now = chrono::to_monotonic(clock_.now()).milliseconds;
+
+        // Each run of the controller starts with a session record holding the absolute time, which the deltas
+        // of the records that follow are relative to.
+        if (!session_)
+        {
+            record_writer_t session{ record_t::session, static_cast<uint64_t>(now) };
+            if (append(session))
+            {
+                session_ = true;
+                last_record_ms_ = now;
+            }
+        }
+
+        pending_record_ms_ = now;
+        return record_writer_t{ type, static_cast<uint64_t>(now - last_record_ms_) };
+    }
+
+    void logger_t::commit(record_writer_t &record) noexcept
+    {
+        // Records are only ever timestamped relative to the last record that actually made it into the ring.
+        if (!session_ || record.overflowed())
+            return;
+
+        if (!append(record))
+            return;
+
+        // The age of the ring is that of the record that has waited longest, from when it was logged.
+        if (!oldest_)
+            oldest_ = chrono::from_monotonic(chrono::monotonic_time_t{ pending_record_ms_ });
+        last_record_ms_ = pending_record_ms_;
+    }
+
+    bool logger_t::append(record_writer_t &record) noexcept
+    {
+        // Pad out the sector rather than let a record straddle it, so every sector in use starts with a record.
+        uint32_t const in_sector = append_offset_ % sector_size;
+        uint32_t const padding = (in_sector + record.size() > sector_size) ? sector_size - in_sector : 0u;
+        uint32_t offset = append_offset_ + padding;
+        uint32_t segment = append_segment_;
+        uint32_t end = append_end_;
+        if (offset >= end)
+        {
+            offset = 0u;
+            ++segment;
+            end = next_size_;
+        }
+
+        uint8_t sequence = sequence_;
+        ring_.begin_record();
+        ring_.write(zero_sector.data(), padding);
+
+        // The segment record carries the time the deltas that follow it are relative to, so each segment decodes on
+        // its own once older ones have been reused.
+        if (offset == 0u)
+        {
+            record_writer_t header{ record_t::segment, static_cast<uint64_t>(last_record_ms_) };
+            header.put(segment);
+            ring_.write(header.frame(sequence++), header.size());
+            offset += header.size();
+        }
+
+        ring_.write(record.frame(sequence++), record.size());
+        if (!ring_.end_record())
+            return false;
+
+        sequence_ = sequence;
+        urgent_ = urgent_ || urgent(record.type());
+        append_offset_ = offset + record.size();
+        append_segment_ = segment;
+        append_end_ = end;
+        return true;
+    }
+
+    bool logger_t::value_changed(value_msg_t const &vm) noexcept
+    {
+        auto itr = std::find_if(values_.begin(), values_.end(), [&](logged_value_t const &lv)
+        {
+            return lv.id.address == vm.id.address;
+        });
+
+        if (itr == values_.end())
+        {
+            if (!values_.full())
+                values_.push_back(logged_value_t{ vm.id, vm.value });
+            return true;
+        }
+
+        if (itr->value == vm.value)
+            return false;
+
+        itr->value = vm.value;
+        return true;
+    }
+
+    void logger_t::write_out(std::size_t count) noexcept
+    {
+        if (file_ && file_offset_ >= segment_end_)
+            rotate();
+
+        // Without a log file there is nowhere to put the bytes, so drop them rather than stall the ring.
+        if (file_)
+            file_.write(ring_.front(), count);
+        file_offset_ += count;
+        ring_.consume(count);
+    }
+
+    std::size_t logger_t::to_sector_boundary() const noexcept
+    {
+        return sector_size - (file_offset_ % sector_size);
     }
 }
\ No newline at end of file
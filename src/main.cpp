@@ -35,72 +35,199 @@
 #include <string_view>
 
 #include "config.hpp"
+#include "config_watcher.hpp"
+#include "cycle_analytics.hpp"
 #include "display.hpp"
 #include "event_queue.hpp"
 #include "logging.hpp"
 #include "modbus_io.hpp"
+#include "profiler.hpp"
 #include "pump_state.hpp"
 #include "monotonic_clock.hpp"
+#include "runtime_counters.hpp"
+#include "series_recorder.hpp"
 
 
 io::modbus_t modbus;
 io::display_t display;
-io::logger_t logger{ display };
 chrono::monotonic_clock_t rtc_time;
+io::logger_t logger{ display, rtc_time };
 chrono::event_queue_t events;
 control::pump_t pump{ logger, rtc_time, events };
+io::series_recorder_t recorder;
+io::data_flash_t data_flash;
+io::counter_store_t counter_store{ data_flash };
+control::runtime_counters_t counters{ counter_store };
+control::cycle_analytics_t cycles{ logger };
+io::config_watcher_t config_watcher{ modbus, logger };
+io::configuration_t config;
+#if defined(PUMP_PROFILING)
+chrono::profiler_t profiler;
+#endif
 
 constexpr chrono::duration_t pump_update_interval = std::chrono::milliseconds(250u);
+bool first_pump_update = true;
 void handle_pump_update(chrono::time_point_t scheduled_time, chrono::time_point_t now)
 {
   pump.update();
+  if (first_pump_update)
+  {
+    first_pump_update = false;
+    logger.log(LOG_MSG("boot ms: "), millis());
+  }
   events.schedule(chrono::event_t{ handle_pump_update, now + pump_update_interval });
 }
 
+void handle_pump_sample(control::sample_t const &sample)
+{
+  recorder.record(sample);
+  counters.record(sample);
+  cycles.record(sample);
+}
+
+void write_init_registers(io::init_registers_t const &init_regs)
+{
+  // Drives keep these in EEPROM, so they are only written when the drive does not already hold the value.
+  for (io::init_register_t const &init : init_regs)
+  {
+    io::expected_value_t const current = modbus.read_holding_register(init.reg);
+    logger.log_on_error(current);
+    if (current && *current == init.value)
+      continue;
+
+    io::expected_void_t const written = modbus.write_register(init.reg, init.value);
+    logger.log_on_error(written);
+    if (written)
+      logger.log<io::level_t::info>(io::value_msg_t{ LOG_MSG("init register: "), init.reg, init.value });
+  }
+}
+
+void handle_config_change(io::configuration_t const &reloaded)
+{
+  // Either all of the new file is applied or none of it, so the controller never runs on a mix of the two.
+  if (auto setting = io::restart_setting(config, reloaded))
+  {
+    logger.log_on_failure<io::level_t::warning>(false, *setting);
+    logger.log<io::level_t::warning>(LOG_MSG("config needs restart"));
+    return;
+  }
+  if (!pump.reconfigure(reloaded.args))
+    return;
+
+  logger.set_level(reloaded.log_level);
+  logger.set_rotation(reloaded.log_rotation);
+  logger.set_repeat_window(reloaded.log_repeat_window);
+  display.configure(reloaded.display);
+  recorder.configure(reloaded.recorder);
+  cycles.configure(reloaded.cycles);
+  config = reloaded;
+  logger.log(LOG_MSG("config reloaded"));
+}
+
+#if defined(PUMP_PROFILING)
+constexpr chrono::duration_t profile_dump_interval = std::chrono::minutes(1u);
+void handle_profile_dump(chrono::time_point_t scheduled_time, chrono::time_point_t now)
+{
+  profiler.dump(Serial);
+  logger.dump_stats(Serial);
+  display.dump_stats(Serial);
+  cycles.dump_stats(Serial);
+  logger.log(profiler);
+  events.schedule(chrono::event_t{ handle_profile_dump, now + profile_dump_interval });
+}
+#endif
+
 void setup() 
 {
-  display.begin();
+#if defined(PUMP_PROFILING)
+  Serial.begin(115200);
+#endif
+  display.begin(rtc_time.now());
   delay(100);
 
   // Disable other SPI devices.
   pinMode(io::cs_pin, OUTPUT);
   digitalWrite(io::cs_pin, HIGH);
 
-  logger.log_on_failure(SD.begin(io::cs_pin), "SD init failed");
-  logger.begin_log(io::log_file_path);
-  logger.log("-- pump controller startup --");
+  logger.log_on_failure(SD.begin(io::cs_pin), LOG_MSG("SD init failed"));
+  logger.begin_log(io::log_file_base);
+  logger.log(LOG_MSG("-- pump controller startup --"));
 
-  io::configuration_t config = read_config("CONFIG.JSN", modbus, logger);
+  unsigned long const config_start = millis();
+  config = read_config("CONFIG.JSN", modbus, logger);
+  logger.log(LOG_MSG("config ms: "), millis() - config_start);
+  logger.set_level(config.log_level);
+  logger.set_rotation(config.log_rotation);
+  logger.set_repeat_window(config.log_repeat_window);
+  display.configure(config.display);
 
   Serial1.begin(config.modbus_buad);
-  modbus.connect(io::connection_args_t{config.modbus_id, Serial1 });
+  modbus.connect(io::connection_args_t{ .id = config.modbus_id, .serial = Serial1,
+    .turnaround_ms = config.modbus_turnaround_ms,
+#if defined(PUMP_PROFILING)
+    .profiler = &profiler
+#endif
+  });
+  write_init_registers(config.init_registers);
   
+  recorder.begin(io::series_file_path, config.recorder);
+  counters.begin();
+  cycles.begin(config.cycles);
+  logger.log(LOG_MSG("pump starts: "), counters.counters().starts);
+  logger.log(LOG_MSG("pump run hours: "), counters.counters().run_seconds / 3600u);
+  pump.on_sample(handle_pump_sample);
+
   delay(100); // Allow some start-up time after modbus connection before pump start-up logic.
   pump.begin(config.args);
+  config_watcher.begin("CONFIG.JSN", config.json, handle_config_change);
   
   // Start events processing!
   chrono::time_point_t now = rtc_time.now();
   events.schedule(chrono::event_t{ handle_pump_update, now + pump_update_interval });
+#if defined(PUMP_PROFILING)
+  events.schedule(chrono::event_t{ handle_profile_dump, now + profile_dump_interval });
+#endif
 }
 
 
-constexpr std::size_t flush_interval = 100u; // A 4 second interval.
-std::size_t loop_iterator = 0;
+constexpr unsigned long loop_budget = 10ul; // Milliseconds.
 void loop() 
 {
   auto t0 = millis();
-  auto now = rtc_time.now();
-  events.process_events(now);
-  now = rtc_time.now();
-  display.update(now);
-
-  // Flush file buffer on interval.
-  if (++loop_iterator % flush_interval == 0u)
-    logger.flush();
+  {
+    PROFILE_SCOPE(profiler, chrono::scope_t::loop);
+    auto now = rtc_time.now();
+    {
+      PROFILE_SCOPE(profiler, chrono::scope_t::process_events);
+      events.process_events(now);
+    }
+    now = rtc_time.now();
+    {
+      PROFILE_SCOPE(profiler, chrono::scope_t::display_update);
+      display.update(now);
+    }
+
+    {
+      PROFILE_SCOPE(profiler, chrono::scope_t::logger_update);
+      logger.update(now);
+    }
+
+    {
+      PROFILE_SCOPE(profiler, chrono::scope_t::recorder_update);
+      recorder.update(now);
+    }
+
+    {
+      PROFILE_SCOPE(profiler, chrono::scope_t::config_watch);
+      config_watcher.update(now);
+    }
+  }
 
   // Calc the duration to delay, if any.
   auto t1 = millis();
   auto elapsed = t1 - t0;
-  if (elapsed <= 10ul)
-    delay(10ul - elapsed);
+  if (elapsed <= loop_budget)
+    delay(loop_budget - elapsed);
+  else
+    PROFILE_OVERRUN(profiler);
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "matrix_sink.hpp"
+
+#if !defined(ARDUINO)
+#include <istream>
+#include <ostream>
+#include <string>
+#endif
+
+namespace io
+{
+#if defined(ARDUINO)
+    bool matrix_sink_t::begin() noexcept
+    {
+        return matrix_.begin();
+    }
+
+    void matrix_sink_t::show(uint32_t const *pixels) noexcept
+    {
+        matrix_.loadFrame(pixels);
+    }
+
+    void matrix_sink_t::play(frame_t const *frames, uint32_t bytes, sequence_done_t done) noexcept
+    {
+        matrix_.setCallback(done);
+        matrix_.loadWrapper(frames, bytes);
+        matrix_.play();
+    }
+#else
+    bool matrix_sink_t::begin() noexcept
+    {
+        return true;
+    }
+
+    void matrix_sink_t::show(uint32_t const *pixels) noexcept
+    {
+        done_ = nullptr;
+        frames_.push_back(captured_t{ { pixels[0], pixels[1], pixels[2] }, now_, 0u });
+    }
+
+    /**
+    * The whole sequence is captured at once, each frame stamped with the time it would appear.  The sequence only
+    * ends, calling 'done', when the harness says so with complete().
+    */
+    void matrix_sink_t::play(frame_t const *frames, uint32_t bytes, sequence_done_t done) noexcept
+    {
+        done_ = done;
+        chrono::time_point_t visible = now_;
+        for (uint32_t i = 0u; i != bytes / sizeof(frame_t); ++i)
+        {
+            frames_.push_back(captured_t{ { frames[i][0], frames[i][1], frames[i][2] }, visible, frames[i][3] });
+            visible += std::chrono::milliseconds{ frames[i][3] };
+        }
+    }
+
+    void matrix_sink_t::complete() noexcept
+    {
+        sequence_done_t const done = done_;
+        done_ = nullptr;
+        if (done != nullptr)
+            done();
+    }
+
+    bool pixel(uint32_t const *pixels, int x, int y) noexcept
+    {
+        uint32_t const bit = static_cast<uint32_t>(y * matrix_width + x);
+        return (pixels[bit / 32u] & (0x80000000u >> (bit % 32u))) != 0u;
+    }
+
+    void write_ascii(std::ostream &out, std::vector<matrix_sink_t::captured_t> const &frames)
+    {
+        for (std::size_t i = 0u; i != frames.size(); ++i)
+        {
+            out << "frame " << i << ' ' << frames[i].duration_ms << '\n';
+            for (int y = 0; y != matrix_height; ++y)
+            {
+                for (int x = 0; x != matrix_width; ++x)
+                    out << (pixel(frames[i].pixels.data(), x, y) ? '#' : '.');
+                out << '\n';
+            }
+        }
+    }
+
+    void write_pgm(std::ostream &out, std::vector<matrix_sink_t::captured_t> const &frames)
+    {
+        std::size_t const rows = frames.empty() ? 0u : frames.size() * (matrix_height + 1u) - 1u;
+        out << "P2\n" << matrix_width << ' ' << rows << "\n255\n";
+        for (std::size_t i = 0u; i != frames.size(); ++i)
+        {
+            if (i != 0u)
+            {
+                for (int x = 0; x != matrix_width; ++x)
+                    out << "64 ";
+                out << '\n';
+            }
+            for (int y = 0; y != matrix_height; ++y)
+            {
+                for (int x = 0; x != matrix_width; ++x)
+                    out << (pixel(frames[i].pixels.data(), x, y) ? "255 " : "0 ");
+                out << '\n';
+            }
+        }
+    }
+
+    std::optional<std::size_t> compare_ascii(std::istream &golden, std::vector<matrix_sink_t::captured_t> const &frames)
+    {
+        std::string line;
+        std::size_t i = 0u;
+        for (; std::getline(golden, line); ++i)
+        {
+            if (i == frames.size())
+                return i;
+
+            std::string const header = "frame " + std::to_string(i) + ' ' + std::to_string(frames[i].duration_ms);
+            if (line != header)
+                return i;
+
+            for (int y = 0; y != matrix_height; ++y)
+            {
+                if (!std::getline(golden, line) || line.size() != matrix_width)
+                    return i;
+                for (int x = 0; x != matrix_width; ++x)
+                {
+                    if ((line[x] == '#') != pixel(frames[i].pixels.data(), x, y))
+                        return i;
+                }
+            }
+        }
+
+        if (i != frames.size())
+            return i;
+        return std::nullopt;
+    }
+#endif
+}
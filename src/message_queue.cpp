@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "message_queue.hpp"
+
+namespace io
+{
+    bool display_msg_t::same_key(display_msg_t const &other) const noexcept
+    {
+        if (kind != other.kind)
+            return false;
+
+        switch (kind)
+        {
+            case kind_t::error: return error == other.error;
+            case kind_t::value: return value.id.address == other.value.id.address;
+            case kind_t::text: return text == other.text;
+            default: return false;
+        }
+    }
+
+    void message_queue_t::push(display_msg_t msg, chrono::time_point_t now) noexcept
+    {
+        // A newer message with the same key takes the waiting one's place, and keeps its age.
+        auto itr = std::find_if(entries_.begin(), entries_.end(), [&](entry_t const &e)
+        {
+            return e.msg.same_key(msg);
+        });
+        if (itr != entries_.end())
+        {
+            itr->msg = msg;
+            itr->updated = now;
+            ++stats_.coalesced;
+            return;
+        }
+
+        entry_t const entry{ msg, now, now };
+        if (entries_.full())
+        {
+            expire(now);
+        }
+        if (entries_.full())
+        {
+            auto lowest = std::min_element(entries_.begin(), entries_.end(), [&](entry_t const &a, entry_t const &b)
+            {
+                return before(b, a, now);
+            });
+            ++stats_.dropped;
+            if (!before(entry, *lowest, now))
+                return;
+
+            entries_.erase(lowest);
+        }
+
+        entries_.push_back(entry);
+        ++stats_.queued;
+    }
+
+    std::optional<display_msg_t> message_queue_t::pop(chrono::time_point_t now) noexcept
+    {
+        expire(now);
+        if (entries_.empty())
+            return std::nullopt;
+
+        auto next = std::min_element(entries_.begin(), entries_.end(), [&](entry_t const &a, entry_t const &b)
+        {
+            return before(a, b, now);
+        });
+
+        // Saturates rather than wraps: a message left waiting for over 49 days still reads as the longest wait.
+        int64_t const waited = std::chrono::duration_cast<std::chrono::milliseconds>(age(*next, now)).count();
+        uint32_t const waited_ms = static_cast<uint32_t>(
+            std::min<int64_t>(waited, std::numeric_limits<uint32_t>::max()));
+        message_latency_t &latency = stats_.latency[static_cast<std::size_t>(next->msg.severity)];
+        ++latency.shown;
+        latency.total_ms += waited_ms;
+        latency.max_ms = std::max(latency.max_ms, waited_ms);
+
+        display_msg_t const msg = next->msg;
+        entries_.erase(next);
+        return msg;
+    }
+
+    chrono::duration_t message_queue_t::age(entry_t const &entry, chrono::time_point_t now) noexcept
+    {
+        return std::max(now - entry.queued, chrono::duration_t::zero());
+    }
+
+    uint32_t message_queue_t::rank(entry_t const &entry, chrono::time_point_t now) noexcept
+    {
+        uint32_t const steps = static_cast<uint32_t>(std::min<int64_t>(age(entry, now) / message_age_step,
+            message_age_steps));
+        return static_cast<uint32_t>(entry.msg.severity) * message_age_steps + steps;
+    }
+
+    /**
+    * Whether 'a' is to be shown before 'b': higher rank first, then first come first served.
+    */
+    bool message_queue_t::before(entry_t const &a, entry_t const &b, chrono::time_point_t now) noexcept
+    {
+        uint32_t const rank_a = rank(a, now);
+        uint32_t const rank_b = rank(b, now);
+        if (rank_a != rank_b)
+            return rank_a > rank_b;
+        return a.queued < b.queued;
+    }
+
+    void message_queue_t::expire(chrono::time_point_t now) noexcept
+    {
+        auto const stale = [&](entry_t const &e)
+        {
+            return e.msg.kind == display_msg_t::kind_t::value && now - e.updated > reading_ttl;
+        };
+        auto const end = std::remove_if(entries_.begin(), entries_.end(), stale);
+        stats_.expired += static_cast<uint32_t>(std::distance(end, entries_.end()));
+        entries_.erase(end, entries_.end());
+    }
+}
@@ -39,7 +39,8 @@ namespace io
     }
 
     modbus_t::modbus_t() noexcept
-    : stream_(nullptr), modbus_(nullptr), connection_status_(modbus_connection_t::disconnected)
+    : stream_(nullptr), modbus_(nullptr), connection_status_(modbus_connection_t::disconnected), profiler_(nullptr),
+      turnaround_us_(0), last_transaction_us_(0)
     {
         if (::instance == nullptr)
             ::instance = this;
@@ -50,6 +51,9 @@ namespace io
     void modbus_t::connect(connection_args_t args) noexcept
     {
         stream_ = &args.serial;
+        profiler_ = args.profiler;
+        turnaround_us_ = int64_t{ args.turnaround_ms } * 1000;
+        last_transaction_us_ = clock_.micros();
         modbus_->begin(args.id, args.serial);
 
         auto setup_pin = [](optional_pint_t op)
@@ -78,8 +82,10 @@ namespace io
 
     [[nodiscard]] expected_value_t modbus_t::read_holding_register(register_t reg) noexcept
     {
-        delay(20); // NOTE: Manual large minimum silent interval since TECO A510 has modbus implementation issues.
+        wait_turnaround();
+        int64_t const start = clock_.micros();
         auto err = modbus_->readHoldingRegisters(reg.address, 1u);
+        end_transaction(start);
         if (err != ModbusMaster::ModbusMaster::ku8MBSuccess)
         {
             modbus_error_t const me = static_cast<modbus_error_t>(err);
@@ -95,8 +101,10 @@ namespace io
 
     [[nodiscard]] expected_void_t modbus_t::write_register(register_t reg, uint16_t value) noexcept
     {
-        delay(20); // NOTE: Manual large minimum silent interval since TECO A510 has modbus implementation issues.
+        wait_turnaround();
+        int64_t const start = clock_.micros();
         auto err = modbus_->writeSingleRegister(reg.address, value);
+        end_transaction(start);
         if (err != ModbusMaster::ModbusMaster::ku8MBSuccess)
         {
             modbus_error_t const me = static_cast<modbus_error_t>(err);
@@ -114,6 +122,32 @@ namespace io
         modbus_ = new (buffer_) ModbusMaster{};
     }
 
+    void modbus_t::wait_turnaround() noexcept
+    {
+        // Some drives (TECO A510) need a silent interval well beyond the modbus minimum, only the part of it that has
+        // not already passed since the last transaction is waited out, to the microsecond rather than rounded to
+        // a whole millis() tick.
+        int64_t const elapsed = clock_.micros() - last_transaction_us_;
+        if (elapsed < turnaround_us_)
+        {
+            int64_t const remaining = turnaround_us_ - elapsed;
+            if (remaining >= 1000)
+                delay(static_cast<unsigned long>(remaining / 1000));
+            delayMicroseconds(static_cast<unsigned int>(remaining % 1000));
+        }
+    }
+
+    void modbus_t::end_transaction(int64_t start) noexcept
+    {
+        last_transaction_us_ = clock_.micros();
+#if defined(PUMP_PROFILING)
+        if (profiler_ != nullptr)
+            profiler_->record(chrono::scope_t::modbus, chrono::to_profile_micros(last_transaction_us_ - start));
+#else
+        (void)start;
+#endif
+    }
+
     void write_pin(optional_pint_t op, int v)
     {
         if (op)
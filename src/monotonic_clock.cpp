@@ -18,7 +18,9 @@
 
 #include "monotonic_clock.hpp"
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 
 namespace // anonymous namespace - no extern linkage.
 {
@@ -40,8 +42,51 @@ namespace chrono
         return std::chrono::system_clock::time_point(duration);
     }
 
-    monotonic_clock_t::monotonic_clock_t() noexcept
-    : last_millis_(0u), time_(start_time)
+#if defined(ARDUINO)
+    uint32_t hardware_millis() noexcept
+    {
+        return millis();
+    }
+#endif
+
+#if defined(ARDUINO)
+    uint32_t hardware_micros() noexcept
+    {
+        return ::micros();
+    }
+#endif
+
+    uint32_t steady_millis() noexcept
+    {
+        auto const since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+    }
+
+    uint32_t steady_micros() noexcept
+    {
+        auto const since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count());
+    }
+
+    uint64_t virtual_clock_t::micros_ = 0u;
+
+    uint32_t virtual_clock_t::millis() noexcept
+    {
+        return static_cast<uint32_t>(micros_ / 1000u);
+    }
+
+    uint32_t virtual_clock_t::micros() noexcept
+    {
+        return static_cast<uint32_t>(micros_);
+    }
+
+    void virtual_clock_t::advance(duration_t duration) noexcept
+    {
+        micros_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
+    monotonic_clock_t::monotonic_clock_t(millis_source_t source) noexcept
+    : source_(source), last_millis_(0u), sampled_(false), time_(start_time)
     {
         if (::instance == nullptr)
             ::instance = this;
@@ -55,21 +100,36 @@ namespace chrono
 
     void monotonic_clock_t::update() noexcept
     {
-        uint32_t const current = millis();
-        monotonic_time_t::time_t const ellapsed = [&]()
-        {
-            if (current < last_millis_)
-            {
-                monotonic_time_t::time_t const remainder = (std::numeric_limits<uint32_t>::max() - last_millis_);
-                return remainder + 1ll + static_cast<monotonic_time_t::time_t>(current);
-            }
-            else
-            {
-                return static_cast<monotonic_time_t::time_t>(current - last_millis_);
-            }
-        }();
-        time_.milliseconds += ellapsed;
+        uint32_t const current = source_();
+        if (sampled_)
+            time_.milliseconds += elapsed_ticks(last_millis_, current);
         last_millis_ = current;
+        sampled_ = true;
+    }
+
+    high_resolution_clock_t::high_resolution_clock_t(micros_source_t source) noexcept
+    : source_(source), last_micros_(0u), sampled_(false), micros_(start_time.milliseconds * 1000)
+    {}
+
+    time_point_t high_resolution_clock_t::now() noexcept
+    {
+        update();
+        return time_point_t(std::chrono::duration_cast<duration_t>(std::chrono::microseconds(micros_)));
+    }
+
+    int64_t high_resolution_clock_t::micros() noexcept
+    {
+        update();
+        return micros_;
+    }
+
+    void high_resolution_clock_t::update() noexcept
+    {
+        uint32_t const current = source_();
+        if (sampled_)
+            micros_ += elapsed_ticks(last_micros_, current);
+        last_micros_ = current;
+        sampled_ = true;
     }
 
 }
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monotonic_clock.hpp"
+#include "number_format.hpp"
+#include "profiler.hpp"
+
+namespace // anonymous namespace - no extern linkage.
+{
+    chrono::high_resolution_clock_t profiler_clock;
+}
+
+namespace chrono
+{
+    int64_t profiler_micros() noexcept
+    {
+        return ::profiler_clock.micros();
+    }
+
+    profiler_t::profiler_t() noexcept
+    : overruns_(0u)
+    {}
+
+    void profiler_t::record(scope_t scope, uint32_t micros) noexcept
+    {
+        scope_stats_t &stats = stats_[static_cast<std::size_t>(scope)];
+        ++stats.count;
+        stats.total += micros;
+        if (micros < stats.min)
+            stats.min = micros;
+        if (micros > stats.max)
+            stats.max = micros;
+        ++stats.histogram[histogram_bucket(micros)];
+    }
+
+    void profiler_t::record_overrun() noexcept
+    {
+        ++overruns_;
+    }
+
+    void profiler_t::reset() noexcept
+    {
+        stats_.fill(scope_stats_t{});
+        overruns_ = 0u;
+    }
+
+    std::size_t profiler_t::format(scope_t scope, char *buffer, std::size_t size) const noexcept
+    {
+        scope_stats_t const &s = stats(scope);
+        io::text_writer_t line(buffer, size);
+        line.append("profile ").append(scope_name(scope))
+            .append(": n=").append(s.count)
+            .append(" min=").append(s.count == 0u ? 0u : s.min)
+            .append("us mean=").append(s.mean())
+            .append("us max=").append(s.max)
+            .append("us hist=");
+
+        for (std::size_t i = 0; i != histogram_buckets; ++i)
+        {
+            if (i != 0u)
+                line.append(",");
+            line.append(s.histogram[i]);
+        }
+        return line.size();
+    }
+
+    std::size_t profiler_t::format_overruns(char *buffer, std::size_t size) const noexcept
+    {
+        return io::text_writer_t(buffer, size).append("profile overruns: ").append(overruns_).size();
+    }
+
+    constexpr std::size_t line_size = 160u;
+
+#if defined(ARDUINO)
+    void profiler_t::dump(Print &out) const noexcept
+    {
+        char line[line_size];
+        for (std::size_t i = 0; i != num_scopes; ++i)
+        {
+            format(static_cast<scope_t>(i), line, sizeof(line));
+            out.println(line);
+        }
+        format_overruns(line, sizeof(line));
+        out.println(line);
+    }
+#else
+    void profiler_t::dump(std::ostream &out) const
+    {
+        char line[line_size];
+        for (std::size_t i = 0; i != num_scopes; ++i)
+        {
+            format(static_cast<scope_t>(i), line, sizeof(line));
+            out << line << '\n';
+        }
+        format_overruns(line, sizeof(line));
+        out << line << '\n';
+    }
+#endif
+}
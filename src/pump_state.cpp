@@ -45,7 +45,8 @@ namespace control
     constexpr io::register_t reg_pressure{ 0x0C1A };
 
     pump_t::pump_t(io::logger_t &lggr, chrono::monotonic_clock_t &tm, chrono::event_queue_t &vnts) noexcept
-    : logger_(lggr), time_(tm), events_(vnts), failed_pressure_(0u), flooded_(false)
+    : logger_(lggr), time_(tm), events_(vnts), sample_handler_(nullptr), failed_pressure_(0u), faults_(0u),
+      flooded_(false)
     {
         if (::instance == nullptr)
             ::instance = this;
@@ -54,6 +55,7 @@ namespace control
     void pump_t::begin(args_t args) noexcept
     {
         args_ = args;
+        build_calibrations();
         state_ = state_t
         {
              .run = state_item_t
@@ -72,46 +74,82 @@ namespace control
 
         full_stop();
         auto expected = push_state(state_.run, true);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
         expected = push_state(state_.frequency, true);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
 
-        auto expected_pressure = read_input(args_.pressure);
+        auto expected_pressure = read_input(args_.pressure, pressure_table_);
         if (expected_pressure)
-            logger_.log("pressure: " , *expected_pressure);
+            logger_.log(LOG_MSG("pressure: "), *expected_pressure);
 
         if (args_.flood)
         {
-            auto expected_flood = read_input(*args_.flood);
+            auto expected_flood = read_input(*args_.flood, flood_table_);
             if (expected_flood)
-            logger_.log("flood: ", *expected_flood);
+            logger_.log(LOG_MSG("flood: "), *expected_flood);
         }
     }
 
+    /**
+    * Only the levels, run/stop patterns, calibrations and flood trigger and timeout are taken from the new arguments,
+    * between updates so an update never sees a mix of old and new.  The modbus connection, registers and inputs are
+    * kept; a reload that changes them is turned away before it gets here (see io::restart_setting).
+    */
+    bool pump_t::reconfigure(args_t args) noexcept
+    {
+        bool const valid = valid_args(args);
+        logger_.log_on_failure(valid, LOG_MSG("config rejected"));
+        if (valid)
+            pending_args_ = args;
+        return valid;
+    }
+
     void pump_t::update() noexcept
     {   
+        apply_pending_args();
+        faults_ = 0u;
         pull_full_state();
 
         // Apply logic to current input state.
-        auto expected_pressure = read_input(args_.pressure);
+        auto expected_pressure = read_input(args_.pressure, pressure_table_);
         handle_pressure_update(expected_pressure);
         handle_flood_condition();
 
         push_full_state();
-        logger_.log(io::value_msg_t{ "run: ", state_.run.reg, state_.run.desired });
-        logger_.log(io::value_msg_t{ "frequency: ", state_.frequency.reg, state_.frequency.desired });
+        logger_.log(io::value_msg_t{ LOG_MSG("run: "), state_.run.reg, state_.run.desired });
+        logger_.log(io::value_msg_t{ LOG_MSG("frequency: "), state_.frequency.reg, state_.frequency.desired });
+
+        if (sample_handler_ != nullptr)
+        {
+            sample_handler_(sample_t
+            {
+                time_.now(),
+                expected_pressure,
+                state_.run.desired,
+                state_.frequency.desired,
+                is_running(),
+                flooded_,
+                faults_
+            });
+        }
+    }
+
+    void pump_t::on_sample(sample_handler_t handler) noexcept
+    {
+        sample_handler_ = handler;
     }
 
-    [[nodiscard]] pump_t::optional_value_t pump_t::read_input(io::input_source_t input) const noexcept
+    [[nodiscard]] pump_t::optional_value_t pump_t::read_input(io::input_source_t input,
+        io::calibration_table_t const &calibration) noexcept
     {
         auto visitor = lambda_visitor
         {
             [&](io::register_t reg) 
             {
                 auto expected = args_.modbus->read_holding_register(reg);
-                logger_.log_on_error(expected);
+                log_on_error(expected);
                 if (expected)
-                    return optional_value_t{ expected.value() };
+                    return optional_value_t{ calibration(expected.value()) };
                 else
                     return optional_value_t{};
                 
@@ -119,7 +157,7 @@ namespace control
             [&](io::analog_input_t ai)
             {
                 int value = analogRead(ai.pin);
-                return optional_value_t{ static_cast<uint16_t>(value) };
+                return optional_value_t{ calibration(static_cast<uint16_t>(value)) };
             }
         };
         return std::visit(visitor, input);
@@ -151,17 +189,17 @@ namespace control
     void pump_t::pull_full_state() noexcept
     {
         auto expected = pull_state(state_.run);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
         expected = pull_state(state_.frequency);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
     }
 
     void pump_t::push_full_state() noexcept
     {
         auto expected = push_state(state_.run);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
         expected = push_state(state_.frequency);
-        logger_.log_on_error(expected);
+        log_on_error(expected);
     }
 
     void pump_t::handle_pressure_update(optional_value_t expected_pressure) noexcept
@@ -172,7 +210,7 @@ namespace control
             uint16_t const pressure = *expected_pressure;
             update_run(pressure);
             update_frequency(pressure);
-            logger_.log(io::value_msg_t{ "pressure: ", reg_pressure, pressure });
+            logger_.log(io::value_msg_t{ LOG_MSG("pressure: "), reg_pressure, pressure });
         }
         else
         {
@@ -188,12 +226,12 @@ namespace control
     {
         if (args_.flood)
         {
-            auto expected_flood = read_input(*args_.flood);
+            auto expected_flood = read_input(*args_.flood, flood_table_);
             if (expected_flood)
             {
                 uint16_t flood = *expected_flood;
                 update_flood(flood);
-                logger_.log(io::value_msg_t{ "flood: ", reg_flood, flood });
+                logger_.log(io::value_msg_t{ LOG_MSG("flood: "), reg_flood, flood });
             }
     
             if (flooded_)
@@ -253,4 +291,32 @@ namespace control
         state_.frequency.desired = 0u;
         state_.run.desired = args_.run_args.stop;
     }
+
+    void pump_t::apply_pending_args() noexcept
+    {
+        if (!pending_args_)
+            return;
+
+        // Carry the desired run state over to the new patterns, so a running pump is not stopped by the change.
+        run_args_t const &next_run_args = pending_args_->run_args;
+        if (state_.run.desired == args_.run_args.run)
+            state_.run.desired = next_run_args.run;
+        else if (state_.run.desired == args_.run_args.stop)
+            state_.run.desired = next_run_args.stop;
+
+        args_.levels = pending_args_->levels;
+        args_.run_args = next_run_args;
+        args_.flood_trigger_value = pending_args_->flood_trigger_value;
+        args_.flood_timeout = pending_args_->flood_timeout;
+        args_.pressure_calibration = pending_args_->pressure_calibration;
+        args_.flood_calibration = pending_args_->flood_calibration;
+        build_calibrations();
+        pending_args_.reset();
+    }
+
+    void pump_t::build_calibrations() noexcept
+    {
+        pressure_table_.build(args_.pressure_calibration);
+        flood_table_.build(args_.flood_calibration);
+    }
 }
\ No newline at end of file
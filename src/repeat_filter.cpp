@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "repeat_filter.hpp"
+
+namespace io
+{
+    repeat_filter_t::repeat_filter_t() noexcept
+    : window_ms_(std::chrono::duration_cast<std::chrono::milliseconds>(default_repeat_window).count())
+    {}
+
+    void repeat_filter_t::set_window(chrono::duration_t window) noexcept
+    {
+        window_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(window).count();
+    }
+
+    uint32_t repeat_filter_t::make_key(modbus_error_t error, log_site_t site) noexcept
+    {
+        // FNV-1a over the error code, the site's line and the address of its file name.
+        uint32_t hash = 2166136261u;
+        auto mix = [&](uint32_t value)
+        {
+            for (std::size_t i = 0; i != sizeof(value); ++i)
+            {
+                hash ^= (value >> (8u * i)) & 0xFFu;
+                hash *= 16777619u;
+            }
+        };
+
+        mix(static_cast<uint32_t>(error));
+        mix(site.line);
+        mix(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(site.file)));
+        return hash == 0u ? 1u : hash;
+    }
+
+    bool repeat_filter_t::matches(entry_t const &entry, uint32_t key, modbus_error_t error, log_site_t site) noexcept
+    {
+        // The hash only picks the slot and two sites can share it.  File names compare by address, as they are hashed.
+        return entry.key == key && entry.error == error && entry.site.line == site.line && entry.site.file == site.file;
+    }
+
+    repeat_summary_t repeat_filter_t::summarize(entry_t const &entry) noexcept
+    {
+        return repeat_summary_t{ entry.error, entry.site, entry.count, entry.last_ms - entry.first_ms };
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "runtime_counters.hpp"
+
+namespace control
+{
+    runtime_counters_t::runtime_counters_t(io::counter_store_t &store) noexcept
+    : store_(store), run_ms_(0u), frequency_ms_{}, dirty_(false)
+    {}
+
+    void runtime_counters_t::begin() noexcept
+    {
+        counters_ = store_.begin().value_or(io::pump_counters_t{});
+    }
+
+    void runtime_counters_t::record(sample_t const &sample) noexcept
+    {
+        // The pump is stopped and not flooded when the controller starts.
+        bool const was_running = last_ && last_->running;
+        bool const was_flooded = last_ && last_->flooded;
+
+        if (last_ && last_->running)
+        {
+            auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(sample.time - last_->time).count();
+            if (elapsed > 0)
+                add_run_time(last_->frequency, static_cast<uint32_t>(elapsed));
+        }
+
+        if (sample.running && !was_running)
+        {
+            ++counters_.starts;
+            dirty_ = true;
+        }
+
+        if (sample.flooded && !was_flooded)
+        {
+            ++counters_.flood_trips;
+            dirty_ = true;
+        }
+
+        if (sample.faults != 0u)
+        {
+            counters_.modbus_faults += sample.faults;
+            dirty_ = true;
+        }
+
+        last_ = sample;
+        if (!last_commit_)
+            last_commit_ = sample.time;
+
+        if (dirty_ && (sample.time - *last_commit_) >= counter_commit_interval)
+        {
+            // A failed commit is not retried before the next interval, so a bad flash cannot stall the loop.
+            static_cast<void>(store_.commit(counters_));
+            last_commit_ = sample.time;
+            dirty_ = false;
+        }
+    }
+
+    void runtime_counters_t::add_run_time(uint16_t frequency, uint32_t ms) noexcept
+    {
+        run_ms_ += ms;
+        counters_.run_seconds += run_ms_ / 1000u;
+        run_ms_ %= 1000u;
+
+        auto &frequencies = counters_.frequencies;
+        auto itr = std::find_if(frequencies.begin(), frequencies.end(), [&](io::frequency_time_t const &ft)
+        {
+            return ft.frequency == frequency || (ft.frequency == 0u && ft.seconds == 0u);
+        });
+        if (itr == frequencies.end())
+            itr = std::prev(frequencies.end());
+        else
+            itr->frequency = frequency;
+
+        uint32_t &remainder = frequency_ms_[static_cast<std::size_t>(itr - frequencies.begin())];
+        remainder += ms;
+        itr->seconds += remainder / 1000u;
+        remainder %= 1000u;
+        dirty_ = true;
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+
+#include "scroll_canvas.hpp"
+
+namespace io
+{
+    scroll_canvas_t::scroll_canvas_t() noexcept
+    : ArduinoGraphics(matrix_width, matrix_height), pixels_{}, frames_(nullptr), capacity_(0u), used_(0u),
+      milliseconds_per_frame_(0u)
+    {
+        ArduinoGraphics::begin();
+        packedFramebuffer(pixels_);
+    }
+
+    /**
+    * Scrolls 'text' left across the canvas, writing one frame per column into 'frames' (capacity in bytes) and
+    * returning the number of bytes used.  Frames past the capacity are dropped.
+    */
+    uint32_t scroll_canvas_t::render(char const *text, Font const &font, uint32_t milliseconds_per_frame,
+        frame_t *frames, uint32_t bytes) noexcept
+    {
+        frames_ = frames;
+        capacity_ = bytes / sizeof(frame_t);
+        used_ = 0u;
+        milliseconds_per_frame_ = milliseconds_per_frame;
+
+        // Frames are captured, not shown, so the scroll itself must not wait between them.
+        stroke(0xFFFFFFFF);
+        textFont(font);
+        textScrollSpeed(0u);
+        beginText(0, 1, 0xFFFFFF);
+        println(text);
+        endText(SCROLL_LEFT);
+
+        frames_ = nullptr;
+        return used_ * sizeof(frame_t);
+    }
+
+    void scroll_canvas_t::beginDraw()
+    {
+        ArduinoGraphics::beginDraw();
+        std::memset(pixels_, 0, sizeof(pixels_));
+    }
+
+    void scroll_canvas_t::endDraw()
+    {
+        ArduinoGraphics::endDraw();
+        if (frames_ == nullptr || used_ == capacity_)
+            return;
+
+        uint32_t *frame = frames_[used_++];
+        std::memcpy(frame, pixels_, sizeof(pixels_));
+        frame[3] = milliseconds_per_frame_;
+    }
+
+    void scroll_canvas_t::set(int x, int y, uint8_t r, uint8_t g, uint8_t b)
+    {
+        if (x < 0 || x >= matrix_width || y < 0 || y >= matrix_height)
+            return;
+
+        uint32_t const bit = static_cast<uint32_t>(y * matrix_width + x);
+        uint32_t const mask = 0x80000000u >> (bit % 32u);
+        if ((r | g | b) != 0u)
+            pixels_[bit / 32u] |= mask;
+        else
+            pixels_[bit / 32u] &= ~mask;
+    }
+}
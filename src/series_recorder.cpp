@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdlib>
+
+#include "series_recorder.hpp"
+
+namespace io
+{
+    series_recorder_t::series_recorder_t() noexcept
+    : block_offset_(0u), full_offset_(0u), full_pending_(false), dirty_(false)
+    {}
+
+    void series_recorder_t::begin(std::string_view path, recorder_args_t args) noexcept
+    {
+        args_ = args;
+        file_ = SD.open(path.data(), O_READ | O_WRITE | O_CREAT);
+        if (!file_)
+            return;
+
+        // Start a fresh block after whatever earlier runs left behind, carrying on their sequence numbering.
+        uint32_t const size = file_.size();
+        block_offset_ = ((size + series_block_size - 1u) / series_block_size) * series_block_size;
+
+        uint32_t sequence = 0u;
+        if (block_offset_ != 0u)
+        {
+            std::array<uint8_t, 8u> header{};
+            file_.seek(block_offset_ - series_block_size);
+            if (file_.read(header.data(), header.size()) == static_cast<int>(header.size()) && load_le<uint32_t>(header.data()) == series_magic)
+                sequence = load_le<uint32_t>(header.data() + 4u) + 1u;
+        }
+        block_.reset(sequence);
+    }
+
+    void series_recorder_t::configure(recorder_args_t args) noexcept
+    {
+        args_ = args;
+    }
+
+    void series_recorder_t::record(control::sample_t const &sample) noexcept
+    {
+        if (!file_ || !sample.pressure)
+            return;
+
+        if (last_considered_ && (sample.time - *last_considered_) < args_.interval)
+            return;
+        last_considered_ = sample.time;
+
+        series_point_t const point
+        {
+            chrono::to_monotonic(sample.time).milliseconds,
+            *sample.pressure,
+            sample.frequency,
+            sample.run
+        };
+
+        if (significant(point))
+        {
+            if (!block_.append(point))
+            {
+                // The loop writes a full block out long before the next one fills, this is only a backstop.
+                if (full_pending_)
+                    write_block(full_, full_offset_);
+
+                full_ = block_;
+                full_offset_ = block_offset_;
+                full_pending_ = true;
+                block_offset_ += series_block_size;
+                block_.reset(block_.sequence() + 1u);
+                block_.append(point);
+            }
+            last_recorded_ = point;
+            dirty_ = true;
+        }
+    }
+
+    void series_recorder_t::update(chrono::time_point_t now) noexcept
+    {
+        if (!file_)
+            return;
+
+        // At most one block write per call: a filled block first, then the partial one when it is due.
+        if (full_pending_)
+        {
+            write_block(full_, full_offset_);
+            full_pending_ = false;
+        }
+        else if (dirty_ && (now - last_flush_) >= series_flush_interval)
+        {
+            write_block(block_, block_offset_);
+            last_flush_ = now;
+            dirty_ = false;
+        }
+    }
+
+    bool series_recorder_t::significant(series_point_t const &point) const noexcept
+    {
+        if (!last_recorded_)
+            return true;
+
+        series_point_t const &last = *last_recorded_;
+        if (point.run != last.run || point.frequency != last.frequency)
+            return true;
+
+        if (std::abs(static_cast<int32_t>(point.pressure) - static_cast<int32_t>(last.pressure)) > args_.pressure_deadband)
+            return true;
+
+        auto const heartbeat = std::chrono::duration_cast<std::chrono::milliseconds>(args_.heartbeat).count();
+        return (point.time_ms - last.time_ms) >= heartbeat;
+    }
+
+    void series_recorder_t::write_block(series_block_t const &block, uint32_t offset) noexcept
+    {
+        file_.seek(offset);
+        file_.write(block.data().data(), block.data().size());
+        file_.flush();
+    }
+}
@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Reading CONFIG.JSN against the in-memory SD card: a valid file is read as written and cached, every setting that
+* fails validation falls back to its default and keeps the file out of the cache, and each violation reaches the
+* display in full even after the next parse has reported its own.
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SD.h>
+#include <unity.h>
+
+#include "config.hpp"
+#include "config_cache.hpp"
+#include "display.hpp"
+#include "logging.hpp"
+#include "matrix_sink.hpp"
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+#include "scroll_canvas.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    chrono::monotonic_clock_t rtc_time{ chrono::virtual_clock_t::millis };
+    io::display_t display;
+    io::logger_t logger{ display, rtc_time };
+    io::modbus_t modbus;
+
+    std::string const valid_config = R"({
+        "modbus_baud" : 9600,
+        "modbus_id" : 3,
+        "drive" : "delta_c2000",
+        "flood_input" : { "analog_input" : "A1" },
+        "pressure_input" : { "register" : 3098 },
+        "pressure_calibration" :
+        {
+            "type" : "linear",
+            "points" : [ { "raw" : 0, "value" : 0 }, { "raw" : 1000, "value" : 1200 } ]
+        },
+        "stepper_levels" :
+        {
+            "stop" : { "pressure" : 850, "frequency" : 0 },
+            "fill" : { "pressure" : 800, "frequency" : 5000 },
+            "start" : { "pressure" : 770, "frequency" : 5500 }
+        },
+        "flood_trigger_value" : 400,
+        "flood_timeout" : 30,
+        "max_starts_per_hour" : 6,
+        "display" : { "mode" : "dashboard", "pressure_decimals" : 1 },
+        "log_level" : "warning",
+        "log_repeat_window_s" : 120,
+        "log_rotation" : { "segments" : 6, "segment_kb" : 64 },
+        "recorder" : { "interval_ms" : 500, "pressure_deadband" : 3, "heartbeat_s" : 300 }
+    })";
+
+    void write_config(std::string const &text)
+    {
+        SD.clear();
+        File file = SD.open("CONFIG.JSN", O_READ | O_WRITE | O_CREAT);
+        file.write(reinterpret_cast<uint8_t const*>(text.data()), text.size());
+        file.close();
+    }
+
+    std::string replaced(std::string text, std::string const &from, std::string const &to)
+    {
+        text.replace(text.find(from), from.size(), to);
+        return text;
+    }
+
+    io::configuration_t read(std::string const &text)
+    {
+        write_config(text);
+        return io::read_config("CONFIG.JSN", modbus, logger);
+    }
+
+    /**
+    * Runs the display until its queue is empty, keeping every frame it scrolled.
+    */
+    std::vector<io::matrix_sink_t::captured_t> scroll_all()
+    {
+        io::matrix_sink_t &sink = display.sink();
+        sink.clear();
+        for (int i = 0; i != 60000; ++i)
+        {
+            chrono::virtual_clock_t::advance(10ms);
+            chrono::time_point_t const now = rtc_time.now();
+            sink.set_time(now);
+            auto const &frames = sink.frames();
+            if (!frames.empty() && frames.back().duration_ms != 0u &&
+                now >= frames.back().visible + std::chrono::milliseconds{ frames.back().duration_ms })
+            {
+                sink.complete();
+            }
+            display.update(now);
+        }
+        return sink.frames();
+    }
+
+    /**
+    * Whether the frames include a whole scroll of the text, as the display renders it.
+    */
+    bool scrolled(std::vector<io::matrix_sink_t::captured_t> const &frames, std::string const &text)
+    {
+        static io::scroll_canvas_t canvas;
+        static std::array<io::frame_t, 300> expected;
+        std::string const shown = "  " + text;
+        uint32_t const count = canvas.render(shown.c_str(), Font_5x7, 100u, expected.data(), sizeof(expected)) /
+            sizeof(io::frame_t);
+        auto const same = [](io::matrix_sink_t::captured_t const &frame, io::frame_t const &want)
+        {
+            return frame.pixels[0] == want[0] && frame.pixels[1] == want[1] && frame.pixels[2] == want[2];
+        };
+        return std::search(frames.begin(), frames.end(), expected.begin(), expected.begin() + count, same) !=
+            frames.end();
+    }
+}
+
+void setUp()
+{
+    display.configure(io::display_args_t{});
+}
+
+void tearDown()
+{
+}
+
+void test_valid_config()
+{
+    io::configuration_t const config = read(valid_config);
+
+    TEST_ASSERT_EQUAL_UINT32(9600u, config.modbus_buad);
+    TEST_ASSERT_EQUAL_UINT8(3u, config.modbus_id);
+    TEST_ASSERT_TRUE(config.drive == &io::delta_c2000);
+    TEST_ASSERT_EQUAL_UINT16(io::delta_c2000.run_reg.address, config.args.run_reg.address);
+    TEST_ASSERT_EQUAL_UINT16(io::delta_c2000.turnaround_ms, config.modbus_turnaround_ms);
+    TEST_ASSERT_EQUAL_size_t(io::delta_c2000.init_register_count, config.init_registers.size());
+    TEST_ASSERT_TRUE(std::holds_alternative<io::analog_input_t>(*config.args.flood));
+    TEST_ASSERT_EQUAL_UINT16(3098u, std::get<io::register_t>(config.args.pressure).address);
+    TEST_ASSERT_TRUE(config.args.pressure_calibration.kind == io::calibration_kind_t::linear);
+    TEST_ASSERT_EQUAL_UINT16(1200u, config.args.pressure_calibration.points[1].value);
+    TEST_ASSERT_EQUAL_UINT16(850u, config.args.levels.stop.pressure);
+    TEST_ASSERT_EQUAL_UINT16(5500u, config.args.levels.start.frequency);
+    TEST_ASSERT_EQUAL_UINT16(io::delta_c2000.run_args.run, config.args.run_args.run);
+    TEST_ASSERT_EQUAL_UINT16(400u, config.args.flood_trigger_value);
+    TEST_ASSERT_TRUE(config.args.flood_timeout == std::chrono::minutes(30));
+    TEST_ASSERT_EQUAL_UINT16(6u, config.cycles.max_starts_per_hour);
+    TEST_ASSERT_TRUE(config.display.mode == io::display_mode_t::dashboard);
+    TEST_ASSERT_EQUAL_UINT8(1u, config.display.pressure_decimals);
+    TEST_ASSERT_EQUAL_UINT16(5500u, config.display.full_scale_frequency);
+    TEST_ASSERT_TRUE(config.log_level == io::level_t::warning);
+    TEST_ASSERT_TRUE(config.log_repeat_window == std::chrono::seconds(120));
+    TEST_ASSERT_EQUAL_UINT8(6u, config.log_rotation.segments);
+    TEST_ASSERT_EQUAL_UINT32(64u * 1024u, config.log_rotation.segment_size);
+    TEST_ASSERT_TRUE(config.recorder.interval == std::chrono::milliseconds(500));
+    TEST_ASSERT_EQUAL_UINT16(3u, config.recorder.pressure_deadband);
+
+    // Cached, and read back from the cache as parsed.
+    TEST_ASSERT_TRUE(SD.exists(io::config_cache_file));
+    io::configuration_t const cached = io::read_config("CONFIG.JSN", modbus, logger);
+    TEST_ASSERT_TRUE(cached.drive == &io::delta_c2000);
+    TEST_ASSERT_EQUAL_UINT16(850u, cached.args.levels.stop.pressure);
+    TEST_ASSERT_EQUAL_UINT32(config.json.crc, cached.json.crc);
+}
+
+void test_violations_fall_back_to_defaults()
+{
+    io::configuration_t const config = read(R"({
+        "modbus_baud" : "fast",
+        "modbus_id" : 300,
+        "drive" : "acme",
+        "stepper_levels" :
+        {
+            "stop" : { "pressure" : 700, "frequency" : 0 },
+            "fill" : { "pressure" : 790, "frequency" : 5400 },
+            "start" : { "pressure" : 765, "frequency" : 6000 }
+        },
+        "run_args" : { "run" : 5, "stop" : 5 },
+        "log_level" : "loud",
+        "recorder" : { "interval_ms" : 10 },
+        "display" : { "pressure_decimals" : 9 }
+    })");
+
+    TEST_ASSERT_EQUAL_UINT32(io::modbus_serial_speed, config.modbus_buad);
+    TEST_ASSERT_EQUAL_UINT8(io::modbus_id, config.modbus_id);
+    TEST_ASSERT_TRUE(config.drive == &io::default_drive);
+    TEST_ASSERT_EQUAL_UINT16(io::stepper_levels.stop.pressure, config.args.levels.stop.pressure);
+    TEST_ASSERT_EQUAL_UINT16(io::default_drive.run_args.run, config.args.run_args.run);
+    TEST_ASSERT_EQUAL_UINT16(io::default_drive.run_args.stop, config.args.run_args.stop);
+    TEST_ASSERT_EQUAL_UINT16(io::reg_pressure.address, std::get<io::register_t>(config.args.pressure).address);
+    TEST_ASSERT_TRUE(config.log_level == io::log_level);
+    TEST_ASSERT_TRUE(config.recorder.interval == io::recorder_args_t{}.interval);
+    TEST_ASSERT_EQUAL_UINT8(io::display_args_t{}.pressure_decimals, config.display.pressure_decimals);
+
+    // Reported again on every boot until the file is fixed.
+    TEST_ASSERT_FALSE(SD.exists(io::config_cache_file));
+}
+
+void test_violations_are_shown_in_full()
+{
+    scroll_all();
+
+    // Both reports are still waiting when the second parse starts over with its own.
+    std::string const linear = R"("type" : "linear",
+            "points" : [ { "raw" : 0, "value" : 0 }, { "raw" : 1000, "value" : 1200 } ])";
+    read(replaced(valid_config, linear, R"("type" : "piecewise",
+            "points" :
+            [
+                { "raw" : 0, "value" : 0 }, { "raw" : 10, "value" : 10 }, { "raw" : 20, "value" : 20 },
+                { "raw" : 30, "value" : 30 }, { "raw" : 40, "value" : 40 }, { "raw" : 50, "value" : 50 },
+                { "raw" : 60, "value" : 60 }, { "raw" : 70 }
+            ])"));
+    read(replaced(valid_config, R"("log_level" : "warning")", R"("log_level" : "loud")"));
+
+    auto const frames = scroll_all();
+    TEST_ASSERT_TRUE(scrolled(frames, "pressure_calibration.points[7].value: missing"));
+    TEST_ASSERT_TRUE(scrolled(frames, "log_level: unknown"));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_valid_config);
+    RUN_TEST(test_violations_fall_back_to_defaults);
+    RUN_TEST(test_violations_are_shown_in_full);
+    return UNITY_END();
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Reloading CONFIG.JSN while running, against the in-memory SD card: the watcher only parses a file whose stamp has
+* changed, parses it with the same limits as at boot, and a reload that changes a boot only setting is named as such.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <SD.h>
+#include <unity.h>
+
+#include "config.hpp"
+#include "config_watcher.hpp"
+#include "display.hpp"
+#include "logging.hpp"
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    chrono::monotonic_clock_t rtc_time{ chrono::virtual_clock_t::millis };
+    io::display_t display;
+    io::logger_t logger{ display, rtc_time };
+    io::modbus_t modbus;
+    io::config_watcher_t watcher{ modbus, logger };
+
+    std::optional<io::configuration_t> reloaded;
+    uint32_t reloads = 0u;
+
+    void handle_reload(io::configuration_t const &config)
+    {
+        reloaded = config;
+        ++reloads;
+    }
+
+    std::string const base_config = R"({
+        "modbus_baud" : 19200,
+        "modbus_id" : 1,
+        "drive" : "teco_a510",
+        "flood_input" : { "register" : 3097 },
+        "pressure_input" : { "register" : 3098 },
+        "stepper_levels" :
+        {
+            "stop" : { "pressure" : 840, "frequency" : 0 },
+            "fill" : { "pressure" : 790, "frequency" : 5400 },
+            "start" : { "pressure" : 765, "frequency" : 6000 }
+        },
+        "flood_trigger_value" : 500,
+        "flood_timeout" : 60,
+        "display" : { "mode" : "scroll" },
+        "log_level" : "info"
+    })";
+
+    std::string replaced(std::string text, std::string const &from, std::string const &to)
+    {
+        text.replace(text.find(from), from.size(), to);
+        return text;
+    }
+
+    void write_config(std::string const &text)
+    {
+        SD.remove("CONFIG.JSN");
+        File file = SD.open("CONFIG.JSN", O_READ | O_WRITE | O_CREAT);
+        file.write(reinterpret_cast<uint8_t const*>(text.data()), text.size());
+        file.close();
+    }
+
+    /**
+    * Runs the watcher past its next check, long enough to stamp the whole file a chunk per update.
+    */
+    void run_check()
+    {
+        chrono::virtual_clock_t::advance(io::config_check_interval);
+        for (int i = 0; i != 1000; ++i)
+        {
+            chrono::virtual_clock_t::advance(10ms);
+            watcher.update(rtc_time.now());
+        }
+    }
+
+    io::configuration_t boot(std::string const &text)
+    {
+        SD.clear();
+        write_config(text);
+        io::configuration_t const config = io::read_config("CONFIG.JSN", modbus, logger);
+        watcher.begin("CONFIG.JSN", config.json, handle_reload);
+        reloaded.reset();
+        reloads = 0u;
+        return config;
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_unchanged_file_is_not_parsed()
+{
+    boot(base_config);
+    run_check();
+    run_check();
+    TEST_ASSERT_EQUAL_UINT32(0u, reloads);
+}
+
+void test_reload_can_be_applied()
+{
+    io::configuration_t const running = boot(base_config);
+    std::string edited = replaced(base_config, R"("pressure" : 840)", R"("pressure" : 850)");
+    edited = replaced(edited, R"("mode" : "scroll")", R"("mode" : "dashboard")");
+    edited = replaced(edited, R"("log_level" : "info")", R"("log_level" : "warning")");
+    write_config(edited);
+    run_check();
+
+    TEST_ASSERT_EQUAL_UINT32(1u, reloads);
+    TEST_ASSERT_TRUE(reloaded.has_value());
+    TEST_ASSERT_EQUAL_UINT16(850u, reloaded->args.levels.stop.pressure);
+    TEST_ASSERT_TRUE(reloaded->display.mode == io::display_mode_t::dashboard);
+    TEST_ASSERT_TRUE(reloaded->log_level == io::level_t::warning);
+    TEST_ASSERT_FALSE(io::restart_setting(running, *reloaded).has_value());
+
+    // Not parsed again until it changes again.
+    run_check();
+    TEST_ASSERT_EQUAL_UINT32(1u, reloads);
+}
+
+void test_boot_settings_need_restart()
+{
+    struct edit_t
+    {
+        char const *from;
+        char const *to;
+        char const *setting;
+    };
+    constexpr edit_t edits[]
+    {
+        { R"("drive" : "teco_a510")", R"("drive" : "delta_c2000")", "drive" },
+        { R"("modbus_id" : 1)", R"("modbus_id" : 2)", "modbus_id" },
+        { R"("modbus_baud" : 19200)", R"("modbus_baud" : 9600)", "modbus_baud" },
+        { R"({ "register" : 3097 })", R"({ "analog_input" : "A0" })", "flood_input" },
+        { R"({ "register" : 3098 })", R"({ "register" : 3099 })", "pressure_input" },
+        { R"("flood_timeout" : 60,)", R"("flood_timeout" : 60, "run_register" : 8194,)", "run_register" },
+    };
+
+    for (edit_t const &edit : edits)
+    {
+        io::configuration_t const running = boot(base_config);
+        write_config(replaced(base_config, edit.from, edit.to));
+        run_check();
+
+        TEST_ASSERT_TRUE_MESSAGE(reloaded.has_value(), edit.setting);
+        auto const setting = io::restart_setting(running, *reloaded);
+        TEST_ASSERT_TRUE_MESSAGE(setting.has_value(), edit.setting);
+        TEST_ASSERT_TRUE_MESSAGE(*setting == edit.setting, edit.setting);
+    }
+}
+
+void test_reload_takes_what_boot_takes()
+{
+    // Well past the 2 KB the watcher used to buffer, but parsed with the same filter and arena as at boot.
+    std::string padded = base_config;
+    padded.insert(1u, R"("notes" : ")" + std::string(4000u, 'x') + R"(",)");
+    io::configuration_t const running = boot(padded);
+    TEST_ASSERT_EQUAL_UINT16(840u, running.args.levels.stop.pressure);
+
+    write_config(replaced(padded, R"("pressure" : 840)", R"("pressure" : 850)"));
+    run_check();
+    TEST_ASSERT_TRUE(reloaded.has_value());
+    TEST_ASSERT_EQUAL_UINT16(850u, reloaded->args.levels.stop.pressure);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_file_is_not_parsed);
+    RUN_TEST(test_reload_can_be_applied);
+    RUN_TEST(test_boot_settings_need_restart);
+    RUN_TEST(test_reload_takes_what_boot_takes);
+    return UNITY_END();
+}
@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The counter store against the host's DATAFLASH.BIN stand-in: finding the newest snapshot at every fill level of a
+* block and across wrap-around, and skipping snapshots torn by a power loss.  Each begin() on a new data_flash_t is
+* a reboot.
+*/
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include <unity.h>
+
+#include "counter_store.hpp"
+#include "data_flash.hpp"
+
+namespace
+{
+    io::pump_counters_t counters_for(uint32_t n)
+    {
+        io::pump_counters_t counters;
+        counters.starts = n;
+        counters.run_seconds = n * 60u;
+        counters.frequencies[0] = io::frequency_time_t{ 6000u, n * 30u };
+        return counters;
+    }
+
+    std::optional<io::pump_counters_t> reboot()
+    {
+        io::data_flash_t flash;
+        io::counter_store_t store{ flash };
+        return store.begin();
+    }
+
+    /**
+    * Commits snapshots n = first ... last - 1 over a single boot.
+    */
+    void commit_range(uint32_t first, uint32_t last)
+    {
+        io::data_flash_t flash;
+        io::counter_store_t store{ flash };
+        static_cast<void>(store.begin());
+        for (uint32_t n = first; n != last; ++n)
+            TEST_ASSERT_TRUE(store.commit(counters_for(n)));
+    }
+
+    /**
+    * Index of the slot the next commit goes to, found by looking for the first blank magic after a programmed one.
+    */
+    std::size_t next_slot(io::data_flash_t const &flash)
+    {
+        for (std::size_t slot = io::counter_slots; slot-- != 0u;)
+        {
+            uint32_t word = 0u;
+            flash.read(static_cast<uint32_t>(slot * io::counter_slot_size), &word, sizeof(word));
+            if (word != 0xFFFFFFFFu)
+                return (slot + 1u) % io::counter_slots;
+        }
+        return 0u;
+    }
+}
+
+void setUp()
+{
+    std::remove(io::data_flash_file);
+}
+
+void tearDown()
+{
+    std::remove(io::data_flash_file);
+}
+
+void test_empty_store()
+{
+    TEST_ASSERT_FALSE(reboot().has_value());
+}
+
+void test_every_fill_level()
+{
+    // One more than a full lap of the store, so every slot of every block is the newest at some point.
+    for (uint32_t n = 1u; n <= io::counter_slots + 1u; ++n)
+    {
+        commit_range(n, n + 1u);
+        std::optional<io::pump_counters_t> const counters = reboot();
+        TEST_ASSERT_TRUE(counters.has_value());
+        TEST_ASSERT_EQUAL_UINT32(n, counters->starts);
+        TEST_ASSERT_EQUAL_UINT32(n * 60u, counters->run_seconds);
+        TEST_ASSERT_EQUAL_UINT32(n * 30u, counters->frequencies[0].seconds);
+    }
+}
+
+void test_wrap_around()
+{
+    // Several laps of the store in uneven runs between reboots.
+    uint32_t n = 1u;
+    for (uint32_t run : { 5u, 37u, 128u, 1u, 250u, 64u, 3u })
+    {
+        commit_range(n, n + run);
+        n += run;
+        std::optional<io::pump_counters_t> const counters = reboot();
+        TEST_ASSERT_TRUE(counters.has_value());
+        TEST_ASSERT_EQUAL_UINT32(n - 1u, counters->starts);
+    }
+}
+
+void test_torn_commit()
+{
+    commit_range(1u, 20u);
+
+    // A power loss half way through programming slot 19 leaves its first half written and the rest erased.
+    {
+        io::data_flash_t flash;
+        TEST_ASSERT_TRUE(flash.begin());
+        std::size_t const torn = next_slot(flash);
+        TEST_ASSERT_EQUAL_size_t(19u, torn);
+
+        std::array<uint8_t, io::counter_slot_size / 2u> half;
+        flash.read(static_cast<uint32_t>((torn - 1u) * io::counter_slot_size), half.data(), half.size());
+        half[4] += 1u;  // The sequence number that commit would have had.
+        TEST_ASSERT_TRUE(flash.write(static_cast<uint32_t>(torn * io::counter_slot_size), half.data(), half.size()));
+    }
+
+    std::optional<io::pump_counters_t> counters = reboot();
+    TEST_ASSERT_TRUE(counters.has_value());
+    TEST_ASSERT_EQUAL_UINT32(19u, counters->starts);
+
+    // The next commit goes after the torn slot rather than programming over it.
+    commit_range(20u, 21u);
+    counters = reboot();
+    TEST_ASSERT_TRUE(counters.has_value());
+    TEST_ASSERT_EQUAL_UINT32(20u, counters->starts);
+
+    io::data_flash_t flash;
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_EQUAL_size_t(21u, next_slot(flash));
+}
+
+void test_corrupt_newest()
+{
+    commit_range(1u, 40u);
+
+    // Clear a bit in the middle of the newest snapshot, slot 38, so its CRC no longer matches.
+    {
+        io::data_flash_t flash;
+        TEST_ASSERT_TRUE(flash.begin());
+        uint32_t const address = 38u * io::counter_slot_size + 8u;
+        uint8_t byte = 0u;
+        flash.read(address, &byte, 1u);
+        TEST_ASSERT_EQUAL_UINT8(39u, byte);
+        byte = static_cast<uint8_t>(byte & (byte - 1u));
+        TEST_ASSERT_TRUE(flash.write(address, &byte, 1u));
+    }
+
+    std::optional<io::pump_counters_t> const counters = reboot();
+    TEST_ASSERT_TRUE(counters.has_value());
+    TEST_ASSERT_EQUAL_UINT32(38u, counters->starts);
+}
+
+void test_torn_first_slot_of_block()
+{
+    // Slot 16 is the first of block 1: a snapshot torn there leaves block 0 holding the newest intact one.
+    commit_range(1u, 17u);
+    {
+        io::data_flash_t flash;
+        TEST_ASSERT_TRUE(flash.begin());
+        TEST_ASSERT_TRUE(flash.erase(1u));
+        std::array<uint8_t, io::counter_slot_size / 2u> half;
+        flash.read(15u * io::counter_slot_size, half.data(), half.size());
+        half[4] += 1u;
+        TEST_ASSERT_TRUE(flash.write(16u * io::counter_slot_size, half.data(), half.size()));
+    }
+
+    std::optional<io::pump_counters_t> const counters = reboot();
+    TEST_ASSERT_TRUE(counters.has_value());
+    TEST_ASSERT_EQUAL_UINT32(16u, counters->starts);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_store);
+    RUN_TEST(test_every_fill_level);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_torn_commit);
+    RUN_TEST(test_corrupt_newest);
+    RUN_TEST(test_torn_first_slot_of_block);
+    return UNITY_END();
+}
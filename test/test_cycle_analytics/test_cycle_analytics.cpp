@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Pump cycle analytics from start/stop samples: run and off periods, duty, the rolling hour and day the starts are
+* counted over, and the short cycling warning raised once each time the starts in the last hour cross the limit.
+*/
+
+#include <chrono>
+#include <cstdint>
+
+#include <unity.h>
+
+#include "cycle_analytics.hpp"
+#include "display.hpp"
+#include "logging.hpp"
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    chrono::monotonic_clock_t rtc_time{ chrono::virtual_clock_t::millis };
+    io::display_t display;
+    io::logger_t logger{ display, rtc_time };
+
+    chrono::time_point_t const start = chrono::from_monotonic(chrono::start_time);
+
+    void sample(control::cycle_analytics_t &cycles, chrono::duration_t at, bool running)
+    {
+        cycles.record(control::sample_t{ .time = start + at, .running = running });
+    }
+
+    /**
+    * Starts the pump at 'at' and stops it again 'run' later.
+    */
+    void cycle(control::cycle_analytics_t &cycles, chrono::duration_t at, chrono::duration_t run)
+    {
+        sample(cycles, at, true);
+        sample(cycles, at + run, false);
+    }
+
+    /**
+    * Warnings the logger has passed on to the display so far.
+    */
+    uint32_t warnings()
+    {
+        io::message_queue_stats_t const &s = display.queue_stats();
+        return s.queued + s.coalesced;
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_periods_and_duty()
+{
+    control::cycle_analytics_t cycles{ logger };
+    cycles.begin(control::cycle_args_t{});
+
+    // The off period the controller started in has no known start, so it is not counted.
+    sample(cycles, 0min, false);
+    cycle(cycles, 1min, 10min);
+    cycle(cycles, 31min, 5min);
+    sample(cycles, 50min, false);
+
+    control::cycle_stats_t const stats = cycles.stats();
+    TEST_ASSERT_EQUAL_UINT32(2u, stats.starts_hour);
+    TEST_ASSERT_EQUAL_UINT32(2u, stats.starts_day);
+    TEST_ASSERT_EQUAL_UINT32(450000u, stats.mean_run_ms);
+    TEST_ASSERT_EQUAL_UINT32(300000u, stats.min_run_ms);
+    TEST_ASSERT_EQUAL_UINT32(1200000u, stats.mean_off_ms);
+    TEST_ASSERT_EQUAL_UINT32(1200000u, stats.min_off_ms);
+    TEST_ASSERT_EQUAL_UINT16(300u, stats.duty_permille);
+}
+
+void test_rolling_windows()
+{
+    control::cycle_analytics_t cycles{ logger };
+    cycles.begin(control::cycle_args_t{});
+
+    sample(cycles, 0min, false);
+    cycle(cycles, 1min, 1min);
+    cycle(cycles, 56min, 1min);
+    TEST_ASSERT_EQUAL_UINT32(2u, cycles.stats().starts_hour);
+
+    // Starts leave the hour 5 minute slot by 5 minute slot, and stay in the day.
+    sample(cycles, 62min, false);
+    TEST_ASSERT_EQUAL_UINT32(1u, cycles.stats().starts_hour);
+    TEST_ASSERT_EQUAL_UINT32(2u, cycles.stats().starts_day);
+    cycle(cycles, 70min, 2min);
+    sample(cycles, 130min, false);
+    TEST_ASSERT_EQUAL_UINT32(0u, cycles.stats().starts_hour);
+    TEST_ASSERT_EQUAL_UINT32(3u, cycles.stats().starts_day);
+
+    // The day is kept hour by hour.
+    sample(cycles, 24h + 30min, false);
+    TEST_ASSERT_EQUAL_UINT32(1u, cycles.stats().starts_day);
+    TEST_ASSERT_EQUAL_UINT32(120000u, cycles.stats().mean_run_ms);
+    sample(cycles, 25h + 30min, false);
+    TEST_ASSERT_EQUAL_UINT32(0u, cycles.stats().starts_day);
+    TEST_ASSERT_EQUAL_UINT32(0u, cycles.stats().mean_run_ms);
+    TEST_ASSERT_EQUAL_UINT32(0u, cycles.stats().min_run_ms);
+
+    // Long enough without a sample, and nothing of the last day is left.
+    cycle(cycles, 26h, 1min);
+    sample(cycles, 60h, false);
+    TEST_ASSERT_EQUAL_UINT32(0u, cycles.stats().starts_day);
+    TEST_ASSERT_EQUAL_UINT16(0u, cycles.stats().duty_permille);
+}
+
+void test_short_cycling_threshold()
+{
+    control::cycle_analytics_t cycles{ logger };
+    cycles.begin(control::cycle_args_t{ .max_starts_per_hour = 3u });
+    sample(cycles, 0min, false);
+
+    // Up to the limit is fine.
+    uint32_t const before = warnings();
+    for (int i = 0; i != 3; ++i)
+        cycle(cycles, std::chrono::minutes(1 + 10 * i), 2min);
+    TEST_ASSERT_EQUAL_UINT32(before, warnings());
+
+    // One more warns, and further starts while over the limit do not warn again.
+    cycle(cycles, 31min, 2min);
+    uint32_t const crossed = warnings();
+    TEST_ASSERT_GREATER_THAN_UINT32(before, crossed);
+    cycle(cycles, 41min, 2min);
+    TEST_ASSERT_EQUAL_UINT32(5u, cycles.stats().starts_hour);
+    TEST_ASSERT_EQUAL_UINT32(crossed, warnings());
+
+    // Once the hour has dropped back under the limit, crossing it again warns again.
+    cycle(cycles, 121min, 2min);
+    TEST_ASSERT_EQUAL_UINT32(1u, cycles.stats().starts_hour);
+    TEST_ASSERT_EQUAL_UINT32(crossed, warnings());
+    for (int i = 0; i != 3; ++i)
+        cycle(cycles, std::chrono::minutes(131 + 10 * i), 2min);
+    TEST_ASSERT_GREATER_THAN_UINT32(crossed, warnings());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_periods_and_duty);
+    RUN_TEST(test_rolling_windows);
+    RUN_TEST(test_short_cycling_threshold);
+    return UNITY_END();
+}
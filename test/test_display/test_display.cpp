@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The LED matrix display on the host, through the frames its sink captures: what the dashboard draws for a reading
+* and when it lights the fault indicator.
+*/
+
+#include <chrono>
+#include <cstdint>
+
+#include <unity.h>
+
+#include "display.hpp"
+#include "log_format.hpp"
+#include "matrix_sink.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    constexpr io::register_t reg_pressure{ 0x0C1A };
+    constexpr chrono::duration_t loop_period = 10ms;
+
+    io::display_t display;
+    chrono::time_point_t now{};
+
+    /**
+    * Runs the main loop for a while, ending each scroll once its last frame has been shown for its duration.
+    */
+    void run(chrono::duration_t duration)
+    {
+        io::matrix_sink_t &sink = display.sink();
+        for (chrono::time_point_t const end = now + duration; now < end; )
+        {
+            now += loop_period;
+            sink.set_time(now);
+            auto const &frames = sink.frames();
+            if (!frames.empty() && frames.back().duration_ms != 0u &&
+                now >= frames.back().visible + std::chrono::milliseconds{ frames.back().duration_ms })
+            {
+                sink.complete();
+            }
+            display.update(now);
+        }
+    }
+
+    /**
+    * The dashboard as last drawn.
+    */
+    uint32_t const* dashboard()
+    {
+        auto const &frames = display.sink().frames();
+        for (auto itr = frames.rbegin(); itr != frames.rend(); ++itr)
+        {
+            if (itr->duration_ms == 0u)
+                return itr->pixels.data();
+        }
+        TEST_FAIL_MESSAGE("no dashboard drawn");
+        return nullptr;
+    }
+
+    void show_pressure(uint16_t pressure, uint8_t decimals)
+    {
+        display.configure(io::display_args_t{ .mode = io::display_mode_t::dashboard, .pressure_decimals = decimals });
+        display.set(io::value_msg_t{ LOG_MSG("pressure: "), reg_pressure, pressure });
+        run(100ms);
+    }
+
+    bool fault_lit()
+    {
+        uint32_t const *pixels = dashboard();
+        return io::pixel(pixels, 10, 6) && io::pixel(pixels, 11, 7);
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_dashboard_decimal_point()
+{
+    // The point is a single pixel on the bottom row of the digits, in the gap after the digit it follows.
+    show_pressure(812u, 1u);
+    TEST_ASSERT_TRUE(io::pixel(dashboard(), 7, 4));
+    TEST_ASSERT_FALSE(io::pixel(dashboard(), 3, 4));
+
+    show_pressure(812u, 0u);
+    TEST_ASSERT_FALSE(io::pixel(dashboard(), 7, 4));
+
+    // Only the decimals that fit are shown: 0.05 keeps both, 123.45 none.
+    show_pressure(5u, 2u);
+    TEST_ASSERT_TRUE(io::pixel(dashboard(), 3, 4));
+    show_pressure(12345u, 2u);
+    TEST_ASSERT_FALSE(io::pixel(dashboard(), 3, 4));
+    TEST_ASSERT_FALSE(io::pixel(dashboard(), 7, 4));
+}
+
+void test_dashboard_overflow()
+{
+    // "^^^" rather than a clamped 999: each caret lights the top two rows of its digit and nothing below them.
+    for (auto [pressure, decimals] : { std::pair{ 1000u, 0u }, std::pair{ 10000u, 1u } })
+    {
+        show_pressure(static_cast<uint16_t>(pressure), static_cast<uint8_t>(decimals));
+        uint32_t const *pixels = dashboard();
+        for (int digit = 0; digit != 3; ++digit)
+        {
+            int const x = digit * 4;
+            TEST_ASSERT_TRUE(io::pixel(pixels, x + 1, 0));
+            TEST_ASSERT_TRUE(io::pixel(pixels, x, 1) && io::pixel(pixels, x + 2, 1));
+            for (int y = 2; y != 6; ++y)
+            {
+                for (int column = x; column != x + 4; ++column)
+                    TEST_ASSERT_FALSE(io::pixel(pixels, column, y));
+            }
+        }
+    }
+
+    show_pressure(9999u, 1u);
+    TEST_ASSERT_TRUE(io::pixel(dashboard(), 0, 4) || io::pixel(dashboard(), 1, 4));
+}
+
+void test_fault_indicator()
+{
+    show_pressure(812u, 0u);
+    TEST_ASSERT_FALSE(fault_lit());
+
+    // A warning scrolls, but the dashboard comes back without the fault indicator.
+    display.set("short cycling", io::severity_t::warning);
+    run(30s);
+    TEST_ASSERT_FALSE(fault_lit());
+
+    display.set(io::modbus_error_t::response_timeout);
+    run(30s);
+    TEST_ASSERT_TRUE(fault_lit());
+
+    // It stays lit for a minute after the scroll.
+    run(60s);
+    TEST_ASSERT_FALSE(fault_lit());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dashboard_decimal_point);
+    RUN_TEST(test_dashboard_overflow);
+    RUN_TEST(test_fault_indicator);
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Golden frame sequences for the LED matrix display.  Runs io::display_t through tools/display_harness.cpp's script,
+* a minute of pump readings with a fault at 20 s and a pressure step at 40 s on a 10 ms loop, and compares every
+* frame it produces with the sequences checked in beside this file.  The harness compares against the same files:
+*     display_harness scroll --compare test/test_display_golden/scroll.txt
+* After an intended change to what the display draws, set PUMP_RECORD_GOLDEN=1 to record them again, and review the
+* difference before committing it.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#include <unity.h>
+
+#include "display.hpp"
+#include "log_format.hpp"
+#include "matrix_sink.hpp"
+
+namespace
+{
+    using std::chrono::milliseconds;
+
+    constexpr milliseconds loop_period{ 10 };
+    constexpr milliseconds script_length{ 60000 };
+    constexpr milliseconds reading_period{ 1000 };
+    constexpr milliseconds fault_at{ 20000 };
+    constexpr milliseconds pressure_step_at{ 40000 };
+
+    constexpr io::register_t reg_run{ 0x2501 };
+    constexpr io::register_t reg_frequency{ 0x2502 };
+    constexpr io::register_t reg_pressure{ 0x0C1A };
+
+    io::display_t display;
+    chrono::time_point_t start{};
+    std::vector<io::matrix_sink_t::captured_t> frames;
+
+    /**
+    * The harness's script, from wherever the previous test left the display once it has gone quiet, keeping the
+    * frames it produced.
+    */
+    void run_script(io::display_mode_t mode)
+    {
+        io::matrix_sink_t &sink = display.sink();
+        display.configure(io::display_args_t{ .mode = mode });
+        sink.clear();
+
+        for (milliseconds t{ 0 }; t < script_length; t += loop_period)
+        {
+            chrono::time_point_t const now = start + t;
+            sink.set_time(now);
+
+            auto const &shown = sink.frames();
+            if (!shown.empty() && shown.back().duration_ms != 0u &&
+                now >= shown.back().visible + milliseconds{ shown.back().duration_ms })
+            {
+                sink.complete();
+            }
+
+            if (t % reading_period == milliseconds{ 0 })
+            {
+                uint64_t const p = t >= pressure_step_at ? 790u : 810u + (t / reading_period) % 4u;
+                display.set(io::value_msg_t{ LOG_MSG("run: "), reg_run, 1u });
+                display.set(io::value_msg_t{ LOG_MSG("frequency: "), reg_frequency, p < 800u ? 6000u : 5400u });
+                display.set(io::value_msg_t{ LOG_MSG("pressure: "), reg_pressure, p });
+            }
+            if (t == fault_at)
+                display.set(io::modbus_error_t::response_timeout);
+
+            display.update(now);
+        }
+
+        frames = sink.frames();
+
+        // Let the last scroll and the fault indicator run out before the next script.
+        start += script_length + std::chrono::minutes{ 5 };
+        sink.set_time(start);
+        sink.complete();
+        display.update(start);
+    }
+
+    void check_golden(char const *path)
+    {
+        char const *record = std::getenv("PUMP_RECORD_GOLDEN");
+        if (record != nullptr && *record != '\0')
+        {
+            bool recorded;
+            {
+                std::ofstream out{ path };
+                io::write_ascii(out, frames);
+                recorded = out.good();
+            }
+            TEST_ASSERT_TRUE_MESSAGE(recorded, path);
+            TEST_IGNORE_MESSAGE("recorded");
+        }
+
+        // Unity leaves a failed test by longjmp, so close the golden before failing.
+        std::optional<std::size_t> differs;
+        bool opened;
+        {
+            std::ifstream golden{ path };
+            opened = golden.good();
+            if (opened)
+                differs = io::compare_ascii(golden, frames);
+        }
+        TEST_ASSERT_TRUE_MESSAGE(opened, path);
+        if (differs)
+        {
+            static char message[96];
+            std::snprintf(message, sizeof(message), "%s: frame %zu differs", path, *differs);
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_scroll_golden()
+{
+    run_script(io::display_mode_t::scroll);
+    check_golden("test/test_display_golden/scroll.txt");
+}
+
+void test_dashboard_golden()
+{
+    run_script(io::display_mode_t::dashboard);
+    check_golden("test/test_display_golden/dashboard.txt");
+}
+
+int main()
+{
+    display.begin(start);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_scroll_golden);
+    RUN_TEST(test_dashboard_golden);
+    return UNITY_END();
+}
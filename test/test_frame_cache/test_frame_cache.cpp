@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The cache of rendered scroll animations: hits and misses, least recently used eviction, the frames of the entries
+* that stay being packed down intact, and the entry the matrix is playing never being moved.
+*/
+
+#include <cstdint>
+#include <string_view>
+
+#include <unity.h>
+
+#include "frame_cache.hpp"
+
+namespace
+{
+    io::frame_cache_t cache;
+
+    /**
+    * Caches an animation of 'frames' frames for 'text', every word of which is 'fill'.
+    */
+    io::frame_cache_t::entry_t add(std::string_view text, uint32_t frames, uint32_t fill)
+    {
+        io::frame_cache_t::entry_t const space = cache.reserve(text, frames);
+        for (uint32_t i = 0u; i != space.bytes / sizeof(io::frame_t); ++i)
+        {
+            for (uint32_t &word : space.frames[i])
+                word = fill;
+        }
+        auto committed = cache.commit(space.bytes);
+        TEST_ASSERT_TRUE(committed.has_value());
+        return *committed;
+    }
+
+    bool cached(std::string_view text)
+    {
+        return cache.find(text).has_value();
+    }
+
+    void assert_frames(uint32_t fill, io::frame_cache_t::entry_t const &entry)
+    {
+        for (uint32_t i = 0u; i != entry.bytes / sizeof(io::frame_t); ++i)
+        {
+            for (uint32_t word : entry.frames[i])
+                TEST_ASSERT_EQUAL_UINT32(fill, word);
+        }
+    }
+}
+
+void setUp()
+{
+    cache = io::frame_cache_t{};
+}
+
+void tearDown()
+{
+}
+
+void test_hits_and_misses()
+{
+    TEST_ASSERT_FALSE(cache.find("pressure: 52").has_value());
+    io::frame_cache_t::entry_t const added = add("pressure: 52", 10u, 0x52u);
+
+    auto found = cache.find("pressure: 52");
+    TEST_ASSERT_TRUE(found.has_value());
+    TEST_ASSERT_EQUAL_PTR(added.frames, found->frames);
+    TEST_ASSERT_EQUAL_UINT32(10u * sizeof(io::frame_t), found->bytes);
+    TEST_ASSERT_FALSE(cached("pressure: 53"));
+
+    io::frame_cache_stats_t const &stats = cache.stats();
+    TEST_ASSERT_EQUAL_UINT32(1u, stats.hits);
+    TEST_ASSERT_EQUAL_UINT32(2u, stats.misses);
+    TEST_ASSERT_EQUAL_UINT32(0u, stats.evictions);
+
+    // Nothing rendered, nothing cached.
+    (void)cache.reserve("empty", 10u);
+    TEST_ASSERT_FALSE(cache.commit(0u).has_value());
+    TEST_ASSERT_FALSE(cached("empty"));
+}
+
+void test_least_recently_used_is_evicted()
+{
+    char const *texts[io::frame_cache_entries] = { "0", "1", "2", "3", "4", "5", "6", "7" };
+    for (uint32_t i = 0u; i != io::frame_cache_entries; ++i)
+        add(texts[i], 10u, i);
+
+    // Out of entries rather than frames: "0" was used again, so "1" goes.
+    TEST_ASSERT_TRUE(cached("0"));
+    add("8", 10u, 8u);
+    TEST_ASSERT_EQUAL_UINT32(1u, cache.stats().evictions);
+    TEST_ASSERT_FALSE(cached("1"));
+    TEST_ASSERT_TRUE(cached("0"));
+    TEST_ASSERT_TRUE(cached("2"));
+    TEST_ASSERT_TRUE(cached("8"));
+}
+
+void test_eviction_packs_frames()
+{
+    constexpr uint32_t quarter = io::frame_cache_frames / 4u;
+    io::frame_cache_t::entry_t const a = add("a", quarter, 0xAu);
+    add("b", quarter, 0xBu);
+    add("c", quarter, 0xCu);
+    add("d", quarter, 0xDu);
+
+    // "b" makes way, and the entries after it slide down over its frames.
+    TEST_ASSERT_TRUE(cached("a"));
+    io::frame_cache_t::entry_t const e = add("e", quarter, 0xEu);
+    TEST_ASSERT_EQUAL_UINT32(1u, cache.stats().evictions);
+    TEST_ASSERT_FALSE(cached("b"));
+
+    auto c = cache.find("c");
+    auto d = cache.find("d");
+    TEST_ASSERT_TRUE(c && d);
+    TEST_ASSERT_EQUAL_PTR(a.frames + quarter, c->frames);
+    TEST_ASSERT_EQUAL_PTR(a.frames + 2u * quarter, d->frames);
+    TEST_ASSERT_EQUAL_PTR(a.frames + 3u * quarter, e.frames);
+    assert_frames(0xAu, a);
+    assert_frames(0xCu, *c);
+    assert_frames(0xDu, *d);
+    assert_frames(0xEu, e);
+}
+
+void test_playing_entry_stays_put()
+{
+    constexpr uint32_t quarter = io::frame_cache_frames / 4u;
+    io::frame_cache_t::entry_t const a = add("a", quarter, 0xAu);
+    add("b", quarter, 0xBu);
+    io::frame_cache_t::entry_t const c = add("c", quarter, 0xCu);
+    add("d", quarter, 0xDu);
+    cache.set_playing(c.frames);
+
+    // "a" and "b" are dropped where they are, and only "d", after it, can give up the space.
+    io::frame_cache_t::entry_t const e = add("e", quarter, 0xEu);
+    TEST_ASSERT_EQUAL_UINT32(3u, cache.stats().evictions);
+    TEST_ASSERT_EQUAL_PTR(a.frames + 3u * quarter, e.frames);
+    auto playing = cache.find("c");
+    TEST_ASSERT_TRUE(playing.has_value());
+    TEST_ASSERT_EQUAL_PTR(c.frames, playing->frames);
+    assert_frames(0xCu, c);
+
+    // Only what is left after it can be had while it plays.
+    io::frame_cache_t::entry_t const f = add("f", 2u * quarter, 0xFu);
+    TEST_ASSERT_EQUAL_UINT32(quarter * sizeof(io::frame_t), f.bytes);
+    assert_frames(0xCu, c);
+
+    // Once it is done it can go too, and the pool is packed again.
+    cache.set_playing(nullptr);
+    io::frame_cache_t::entry_t const g = add("g", 3u * quarter, 0x6u);
+    TEST_ASSERT_FALSE(cached("c"));
+    auto moved = cache.find("f");
+    TEST_ASSERT_TRUE(moved.has_value());
+    TEST_ASSERT_EQUAL_PTR(a.frames, moved->frames);
+    assert_frames(0xFu, *moved);
+    TEST_ASSERT_EQUAL_PTR(a.frames + quarter, g.frames);
+    TEST_ASSERT_EQUAL_UINT32(3u * quarter * sizeof(io::frame_t), g.bytes);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hits_and_misses);
+    RUN_TEST(test_least_recently_used_is_evicted);
+    RUN_TEST(test_eviction_packs_frames);
+    RUN_TEST(test_playing_entry_stays_put);
+    return UNITY_END();
+}
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The bump allocator configuration parses run in: blocks stay aligned, only the most recent block is grown, shrunk
+* or freed in place, an allocation that does not fit fails rather than overrunning the buffer, and reset() starts
+* the counts over for the next parse.
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <unity.h>
+
+#include "json_arena.hpp"
+
+namespace
+{
+    constexpr std::size_t arena_size = 1024u;
+    constexpr std::size_t header = alignof(std::max_align_t);
+
+    alignas(std::max_align_t) std::array<uint8_t, arena_size> buffer;
+    io::json_arena_t arena{ buffer.data(), buffer.size() };
+
+    bool aligned(void const *ptr)
+    {
+        return reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t) == 0u;
+    }
+}
+
+void setUp()
+{
+    arena.reset();
+}
+
+void tearDown()
+{
+}
+
+void test_blocks_are_aligned()
+{
+    for (std::size_t size : { 1u, 3u, 16u, 17u, 40u })
+    {
+        void *block = arena.allocate(size);
+        TEST_ASSERT_NOT_NULL(block);
+        TEST_ASSERT_TRUE(aligned(block));
+    }
+    TEST_ASSERT_EQUAL_size_t(5u * header + 16u + 16u + 16u + 32u + 48u, arena.used());
+}
+
+void test_last_block_changes_in_place()
+{
+    void *first = arena.allocate(16u);
+    void *last = arena.allocate(16u);
+    std::memset(last, 0x5A, 16u);
+
+    // Grown and shrunk where it is.
+    TEST_ASSERT_EQUAL_PTR(last, arena.reallocate(last, 200u));
+    TEST_ASSERT_EQUAL_UINT8(0x5A, static_cast<uint8_t*>(last)[15]);
+    std::size_t const grown = arena.used();
+    TEST_ASSERT_EQUAL_PTR(last, arena.reallocate(last, 8u));
+    TEST_ASSERT_LESS_THAN_size_t(grown, arena.used());
+
+    // Freed, so the next block takes its place.
+    arena.deallocate(last);
+    TEST_ASSERT_EQUAL_PTR(last, arena.allocate(32u));
+
+    // An earlier block is only moved when it has to grow.
+    TEST_ASSERT_EQUAL_PTR(first, arena.reallocate(first, 10u));
+    std::memset(first, 0xA5, 16u);
+    void *moved = arena.reallocate(first, 64u);
+    TEST_ASSERT_NOT_NULL(moved);
+    TEST_ASSERT_TRUE(moved != first);
+    TEST_ASSERT_EQUAL_UINT8(0xA5, static_cast<uint8_t*>(moved)[15]);
+
+    // Freeing anything but the last block gives nothing back.
+    std::size_t const used = arena.used();
+    arena.deallocate(first);
+    TEST_ASSERT_EQUAL_size_t(used, arena.used());
+}
+
+void test_exact_fit_and_overflow()
+{
+    void *block = arena.allocate(arena_size - header);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT_EQUAL_size_t(arena_size, arena.used());
+    TEST_ASSERT_NULL(arena.allocate(1u));
+    TEST_ASSERT_NULL(arena.reallocate(block, arena_size));
+    TEST_ASSERT_EQUAL_UINT32(2u, arena.failures());
+
+    arena.reset();
+    TEST_ASSERT_NULL(arena.allocate(arena_size));
+    TEST_ASSERT_NULL(arena.allocate(SIZE_MAX - 4u));
+    TEST_ASSERT_EQUAL_size_t(0u, arena.used());
+}
+
+void test_reset_starts_counts_over()
+{
+    arena.allocate(600u);
+    arena.allocate(arena_size);
+    TEST_ASSERT_EQUAL_size_t(header + 608u, arena.peak());
+    TEST_ASSERT_EQUAL_UINT32(1u, arena.failures());
+
+    // The next parse reports its own peak, not the largest one since boot.
+    arena.reset();
+    TEST_ASSERT_EQUAL_size_t(0u, arena.peak());
+    TEST_ASSERT_EQUAL_UINT32(0u, arena.failures());
+    arena.allocate(100u);
+    TEST_ASSERT_EQUAL_size_t(header + 112u, arena.peak());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_are_aligned);
+    RUN_TEST(test_last_block_changes_in_place);
+    RUN_TEST(test_exact_fit_and_overflow);
+    RUN_TEST(test_reset_starts_counts_over);
+    return UNITY_END();
+}
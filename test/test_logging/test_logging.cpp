@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The logger against the in-memory SD card: when buffered records go out to the file and it is flushed, and how
+* segments are rotated when the background fill has not kept up or the card is full.  Also which log calls reach the
+* display.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include <SD.h>
+#include <unity.h>
+
+#include "display.hpp"
+#include "logging.hpp"
+#include "monotonic_clock.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    chrono::monotonic_clock_t rtc_time{ chrono::virtual_clock_t::millis };
+    io::display_t display;
+    io::logger_t logger{ display, rtc_time };
+
+    std::size_t written(char const *name)
+    {
+        auto const &contents = SD.contents(name);
+        return static_cast<std::size_t>(std::count_if(contents.begin(), contents.end(), [](uint8_t b) { return b != 0u; }));
+    }
+
+    void advance(chrono::duration_t duration)
+    {
+        chrono::virtual_clock_t::advance(duration);
+        logger.update(rtc_time.now());
+    }
+
+    constexpr io::log_rotation_t small_rotation{ .segments = 4u, .segment_size = io::min_segment_size };
+
+    void start_log()
+    {
+        logger.flush();
+        SD.clear();
+        logger.begin_log(io::log_file_base);
+        logger.set_rotation(small_rotation);
+    }
+
+    /**
+    * Logs a little over a sector per update, so the ring always has a full sector to write out and the logger is
+    * never idle long enough to zero fill the next segment.
+    */
+    void log_busily(uint32_t updates)
+    {
+        for (uint32_t i = 0u; i != updates; ++i)
+        {
+            for (uint32_t j = 0u; j != 80u; ++j)
+                logger.log(LOG_MSG("pump starts: "), i * 100u + j);
+            advance(10ms);
+        }
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_age_counts_from_commit()
+{
+    SD.clear();
+    logger.begin_log(io::log_file_base);
+    logger.log(LOG_MSG("-- pump controller startup --"));
+
+    // The record has waited 3s when the logger first sees it, and 4.5s by the next update.
+    advance(3s);
+    TEST_ASSERT_EQUAL_size_t(0u, written("PMPCTRL.000"));
+    advance(1500ms);
+    TEST_ASSERT_GREATER_THAN_size_t(0u, written("PMPCTRL.000"));
+}
+
+void test_stale_flush_is_deferred()
+{
+    advance(10ms);
+    logger.log(LOG_MSG("-- pump controller startup --"));
+    uint32_t const flushes = SD.flushes();
+    advance(io::log_max_age);
+    TEST_ASSERT_EQUAL_UINT32(flushes, SD.flushes());
+    advance(10ms);
+    TEST_ASSERT_EQUAL_UINT32(flushes + 1u, SD.flushes());
+    advance(10ms);
+    TEST_ASSERT_EQUAL_UINT32(flushes + 1u, SD.flushes());
+}
+
+void test_rotation_does_not_wait_for_fill()
+{
+    start_log();
+    log_busily(12u);
+
+    // The next segment was never filled, and rotating into it did not stop to fill it either.
+    auto const &next = SD.contents("PMPCTRL.001");
+    TEST_ASSERT_GREATER_THAN_size_t(0u, next.size());
+    TEST_ASSERT_LESS_THAN_size_t(small_rotation.segment_size, next.size());
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(io::record_t::segment), next[0]);
+    TEST_ASSERT_EQUAL_size_t(small_rotation.segment_size, SD.contents("PMPCTRL.000").size());
+}
+
+void test_full_card_keeps_current_segment()
+{
+    start_log();
+    SD.set_full(true);
+    log_busily(12u);
+
+    // Nothing could be created, so the log carried on in the segment it had.
+    TEST_ASSERT_FALSE(SD.exists("PMPCTRL.001"));
+    auto const &current = SD.contents("PMPCTRL.000");
+    TEST_ASSERT_GREATER_THAN_size_t(small_rotation.segment_size, current.size());
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(io::record_t::segment), current[small_rotation.segment_size]);
+
+    // Once there is room again, the next rotation moves on.
+    SD.set_full(false);
+    log_busily(12u);
+    TEST_ASSERT_TRUE(SD.exists("PMPCTRL.001"));
+}
+
+void test_warnings_reach_display()
+{
+    io::message_queue_stats_t const &queue = display.queue_stats();
+    uint32_t const queued = queue.queued;
+
+    logger.log(LOG_MSG("pump starts: "), 3u);
+    logger.log(std::string_view{ "informational" });
+    TEST_ASSERT_EQUAL_UINT32(queued, queue.queued);
+
+    // Whatever the overload, a warning is shown.
+    logger.log<io::level_t::warning>(LOG_MSG("short cycling"));
+    logger.log<io::level_t::warning>(LOG_MSG("cycle starts/h: "), 12u);
+    logger.log<io::level_t::error>(std::string_view{ "pressure_sensor: missing" });
+    TEST_ASSERT_EQUAL_UINT32(queued + 3u, queue.queued);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_age_counts_from_commit);
+    RUN_TEST(test_stale_flush_is_deferred);
+    RUN_TEST(test_rotation_does_not_wait_for_fill);
+    RUN_TEST(test_full_card_keeps_current_segment);
+    RUN_TEST(test_warnings_reach_display);
+    return UNITY_END();
+}
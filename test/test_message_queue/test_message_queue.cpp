@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The queue between whoever reports something and the display: faults before warnings before readings, waiting
+* messages catching up as they age, repeats coalescing, stale readings expiring, a full queue keeping the messages
+* that rank highest, and the time from queued to shown measured without wrapping.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <unity.h>
+
+#include "log_format.hpp"
+#include "message_queue.hpp"
+#include "monotonic_clock.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    io::message_queue_t queue;
+    chrono::time_point_t const start = chrono::from_monotonic(chrono::start_time);
+
+    io::display_msg_t reading(uint16_t address, uint64_t value)
+    {
+        return io::display_msg_t{ io::display_msg_t::kind_t::value, io::severity_t::reading,
+            io::modbus_error_t::success, io::value_msg_t{ LOG_MSG("pressure: "), io::register_t{ address }, value } };
+    }
+
+    io::display_msg_t text(std::string_view msg, io::severity_t severity)
+    {
+        return io::display_msg_t{ io::display_msg_t::kind_t::text, severity, io::modbus_error_t::success,
+            io::value_msg_t{}, io::display_text_t{ msg.data(), msg.size() } };
+    }
+
+    void assert_pops(char const *expected, chrono::time_point_t now)
+    {
+        auto msg = queue.pop(now);
+        TEST_ASSERT_TRUE(msg.has_value());
+        TEST_ASSERT_EQUAL_STRING(expected, msg->text.c_str());
+    }
+}
+
+void setUp()
+{
+    queue = io::message_queue_t{};
+}
+
+void tearDown()
+{
+}
+
+void test_higher_severity_first()
+{
+    queue.push(text("reading", io::severity_t::reading), start);
+    queue.push(text("warning", io::severity_t::warning), start + 1s);
+    queue.push(text("fault", io::severity_t::fault), start + 2s);
+    queue.push(text("second fault", io::severity_t::fault), start + 3s);
+
+    assert_pops("fault", start + 3s);
+    assert_pops("second fault", start + 3s);
+    assert_pops("warning", start + 3s);
+    assert_pops("reading", start + 3s);
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_FALSE(queue.pop(start + 3s).has_value());
+}
+
+void test_waiting_messages_catch_up()
+{
+    // After four age steps a reading ranks with a fresh warning and, having waited longer, goes first.
+    queue.push(text("reading", io::severity_t::reading), start);
+    queue.push(text("warning", io::severity_t::warning), start + 20s);
+    assert_pops("reading", start + 20s);
+    assert_pops("warning", start + 20s);
+
+    // But never with a fresh fault.
+    queue.push(text("old reading", io::severity_t::reading), start);
+    queue.push(text("fault", io::severity_t::fault), start + 10min);
+    assert_pops("fault", start + 10min);
+    assert_pops("old reading", start + 10min);
+}
+
+void test_same_key_coalesces()
+{
+    queue.push(reading(0x0C1A, 10u), start);
+    queue.push(reading(0x2502, 5u), start + 1s);
+    queue.push(reading(0x0C1A, 11u), start + 2s);
+    TEST_ASSERT_EQUAL_UINT32(2u, queue.stats().queued);
+    TEST_ASSERT_EQUAL_UINT32(1u, queue.stats().coalesced);
+
+    // The newer value, in the older one's place in the queue.
+    auto msg = queue.pop(start + 3s);
+    TEST_ASSERT_TRUE(msg.has_value());
+    TEST_ASSERT_EQUAL_UINT16(0x0C1A, msg->value.id.address);
+    TEST_ASSERT_EQUAL_UINT64(11u, msg->value.value);
+    TEST_ASSERT_EQUAL_UINT32(3000u, queue.stats().latency[0].max_ms);
+}
+
+void test_stale_readings_expire()
+{
+    queue.push(reading(0x0C1A, 10u), start);
+    queue.push(reading(0x2502, 5u), start);
+    queue.push(text("warning", io::severity_t::warning), start);
+
+    // Coalescing keeps a reading fresh.
+    queue.push(reading(0x2502, 6u), start + 20s);
+    assert_pops("warning", start + 31s);
+    TEST_ASSERT_EQUAL_UINT32(1u, queue.stats().expired);
+
+    auto msg = queue.pop(start + 31s);
+    TEST_ASSERT_TRUE(msg.has_value());
+    TEST_ASSERT_EQUAL_UINT64(6u, msg->value.value);
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_full_queue_keeps_highest_ranked()
+{
+    for (uint16_t i = 0u; i < io::message_queue_capacity; ++i)
+    {
+        queue.push(reading(i, i), start);
+    }
+
+    // A warning displaces a reading, and another reading has nothing it outranks.
+    queue.push(text("warning", io::severity_t::warning), start);
+    queue.push(reading(0x1000, 0u), start);
+    TEST_ASSERT_EQUAL_UINT32(2u, queue.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(io::message_queue_capacity + 1u, queue.stats().queued);
+
+    assert_pops("warning", start);
+    std::size_t left = 0u;
+    while (auto msg = queue.pop(start))
+    {
+        TEST_ASSERT_TRUE(msg->value.id.address != 0x1000);
+        ++left;
+    }
+    TEST_ASSERT_EQUAL_size_t(io::message_queue_capacity - 1u, left);
+}
+
+void test_latency_saturates()
+{
+    // Queued at the clock's epoch, shown a year later: longer than a 32-bit count of milliseconds holds.
+    queue.push(text("fault", io::severity_t::fault), chrono::time_point_t{});
+    assert_pops("fault", start);
+    io::message_latency_t const &fault = queue.stats().latency[static_cast<std::size_t>(io::severity_t::fault)];
+    TEST_ASSERT_EQUAL_UINT32(1u, fault.shown);
+    TEST_ASSERT_EQUAL_UINT32(std::numeric_limits<uint32_t>::max(), fault.max_ms);
+
+    // Stamped after the time it is shown at counts as no wait at all, not as most of 49 days.
+    queue.push(text("warning", io::severity_t::warning), start + 1s);
+    assert_pops("warning", start);
+    io::message_latency_t const &warning = queue.stats().latency[static_cast<std::size_t>(io::severity_t::warning)];
+    TEST_ASSERT_EQUAL_UINT32(0u, warning.max_ms);
+    TEST_ASSERT_EQUAL_UINT32(0u, warning.mean_ms());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_higher_severity_first);
+    RUN_TEST(test_waiting_messages_catch_up);
+    RUN_TEST(test_same_key_coalesces);
+    RUN_TEST(test_stale_readings_expire);
+    RUN_TEST(test_full_queue_keeps_highest_ranked);
+    RUN_TEST(test_latency_saturates);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The packed blitter added to the bundled ArduinoGraphics against the per-pixel bitmap() path it replaces: every
+* bitmap size, position (including clipped at each edge) and colour combination, and scrolled text, must leave
+* exactly the same pixels.
+*/
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include <unity.h>
+
+#include "ArduinoGraphics.h"
+#include "frame_cache.hpp"
+
+namespace
+{
+    // The matrix's 96 pixels in three words, and a guard word after them that neither path may touch.
+    using pixels_t = std::array<uint32_t, 4u>;
+
+    /**
+    * A 12x8 one bit per pixel canvas laid out like the LED matrix frames, drawn either through the packed
+    * framebuffer or one set() per pixel.
+    */
+    class canvas_t : public ArduinoGraphics
+    {
+    public:
+        explicit canvas_t(bool packed)
+        : ArduinoGraphics(io::matrix_width, io::matrix_height), pixels_{}
+        {
+            begin();
+            if (packed)
+                packedFramebuffer(pixels_.data());
+        }
+
+        using ArduinoGraphics::bitmap;
+        using ArduinoGraphics::set;
+
+        void set(int x, int y, uint8_t r, uint8_t g, uint8_t b) override
+        {
+            if (x < 0 || x >= io::matrix_width || y < 0 || y >= io::matrix_height)
+                return;
+
+            uint32_t const bit = static_cast<uint32_t>(y * io::matrix_width + x);
+            uint32_t const mask = 0x80000000u >> (bit % 32u);
+            if ((r | g | b) != 0u)
+                pixels_[bit / 32u] |= mask;
+            else
+                pixels_[bit / 32u] &= ~mask;
+        }
+
+        pixels_t pixels_;
+    };
+
+    /**
+    * xorshift32, so every run draws the same bitmaps.
+    */
+    uint32_t next_random()
+    {
+        static uint32_t state = 0x2545F491u;
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return state;
+    }
+
+    void colours(canvas_t &canvas, bool lit_stroke, bool lit_background)
+    {
+        canvas.stroke(lit_stroke ? 0xFFFFFFu : 0u);
+        canvas.background(lit_background ? 0xFF8000u : 0u);
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_bitmaps_match()
+{
+    std::array<uint8_t, 8u> data{};
+    for (int w = 1; w <= 8; ++w)
+    for (int h = 1; h <= 8; ++h)
+    for (int y = -h - 1; y <= io::matrix_height + 1; ++y)
+    for (int x = -w - 1; x <= io::matrix_width + 1; ++x)
+    for (int c = 0; c != 4; ++c)
+    {
+        for (uint8_t &row : data)
+            row = static_cast<uint8_t>(next_random());
+
+        canvas_t packed{ true };
+        canvas_t reference{ false };
+        packed.pixels_ = reference.pixels_ = pixels_t{ next_random(), next_random(), next_random(), next_random() };
+        colours(packed, c & 1, c & 2);
+        colours(reference, c & 1, c & 2);
+
+        packed.bitmap(data.data(), x, y, w, h);
+        reference.bitmap(data.data(), x, y, w, h);
+        if (packed.pixels_ != reference.pixels_)
+        {
+            char message[96];
+            std::snprintf(message, sizeof(message), "w=%d h=%d x=%d y=%d colours=%d", w, h, x, y, c);
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+}
+
+void test_scrolled_text_matches()
+{
+    char const *text = "pressure: 812";
+    for (Font const *font : { &Font_5x7, &Font_4x6 })
+    for (int x = io::matrix_width; x >= -static_cast<int>(13u * font->width); --x)
+    {
+        canvas_t packed{ true };
+        canvas_t reference{ false };
+        for (canvas_t *canvas : { &packed, &reference })
+        {
+            colours(*canvas, true, false);
+            canvas->textFont(*font);
+            canvas->text(text, x, 1);
+        }
+        TEST_ASSERT_TRUE(packed.pixels_ == reference.pixels_);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bitmaps_match);
+    RUN_TEST(test_scrolled_text_matches);
+    return UNITY_END();
+}
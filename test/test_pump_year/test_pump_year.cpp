@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Runs a simulated year of pump operation through the real pump_t and event_queue_t on virtual time: a tank whose
+* pressure falls with a daily demand curve and rises while the simulated drive runs, and a flood sensor that trips
+* once a month.  The millis() count the clock reads wraps seven times over the year.
+*/
+
+#include <chrono>
+#include <cstdint>
+
+#include <ModbusMaster.h>
+#include <unity.h>
+
+#include "config.hpp"
+#include "display.hpp"
+#include "event_queue.hpp"
+#include "logging.hpp"
+#include "modbus_io.hpp"
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    constexpr chrono::duration_t tick = 10s;
+    constexpr chrono::duration_t year = 24h * 365;
+    constexpr chrono::duration_t flood_every = 24h * 30;
+    constexpr chrono::duration_t flood_wet = 5min;
+    constexpr uint16_t dry = 1000u;
+    constexpr uint16_t wet = 100u;
+
+    class null_stream_t : public Stream
+    {
+    public:
+        size_t write(uint8_t) override  { return 1u; }
+        int available() override        { return 0; }
+        int read() override             { return -1; }
+        int peek() override             { return -1; }
+    };
+
+    chrono::monotonic_clock_t rtc_time{ chrono::virtual_clock_t::millis };
+    io::display_t display;
+    io::logger_t logger{ display, rtc_time };
+    chrono::event_queue_t events;
+    io::modbus_t modbus;
+    control::pump_t pump{ logger, rtc_time, events };
+    null_stream_t serial;
+
+    /**
+    * Everything the sample handler observes over the year.
+    */
+    struct stats_t
+    {
+        uint32_t updates = 0u;
+        uint32_t starts = 0u;
+        uint32_t floods = 0u;
+        uint32_t flooded_running = 0u;     /**< Updates that left the pump running while flooded. */
+        uint32_t mismatched = 0u;          /**< Updates after which the drive did not hold the desired state. */
+        chrono::time_point_t flood_start;
+        chrono::duration_t shortest_hold = chrono::duration_t::max();
+        chrono::duration_t longest_hold = chrono::duration_t::zero();
+        uint16_t max_pressure = 0u;
+        uint16_t min_dry_pressure = UINT16_MAX; /**< Lowest pressure outside floods and the refill after them. */
+        bool running = false;
+        bool flooded = false;
+        bool refilling = false;
+    };
+
+    stats_t stats;
+    double pressure = 800.0;
+
+    void record(control::sample_t const &sample)
+    {
+        ++stats.updates;
+        if (sample.running && !stats.running)
+            ++stats.starts;
+        if (sample.flooded && sample.running)
+            ++stats.flooded_running;
+        if (host::drive_registers[io::reg_run.address] != sample.run ||
+            host::drive_registers[io::reg_frequency.address] != sample.frequency)
+            ++stats.mismatched;
+
+        if (sample.flooded && !stats.flooded)
+        {
+            ++stats.floods;
+            stats.flood_start = sample.time;
+        }
+        else if (!sample.flooded && stats.flooded)
+        {
+            auto const hold = sample.time - stats.flood_start;
+            stats.shortest_hold = std::min(stats.shortest_hold, hold);
+            stats.longest_hold = std::max(stats.longest_hold, hold);
+        }
+
+        if (sample.pressure)
+        {
+            stats.max_pressure = std::max(stats.max_pressure, *sample.pressure);
+            if (sample.flooded)
+                stats.refilling = true;
+            else if (*sample.pressure > io::stepper_levels.start.pressure)
+                stats.refilling = false;
+
+            if (!stats.refilling)
+                stats.min_dry_pressure = std::min(stats.min_dry_pressure, *sample.pressure);
+        }
+
+        stats.running = sample.running;
+        stats.flooded = sample.flooded;
+    }
+
+    void handle_pump_update(chrono::time_point_t, chrono::time_point_t now)
+    {
+        pump.update();
+        events.schedule(chrono::event_t{ handle_pump_update, now + tick });
+    }
+
+    /**
+    * Demand in pressure units per minute: a trickle overnight, peaks in the morning and evening.
+    */
+    double demand(chrono::duration_t elapsed)
+    {
+        auto const hour = std::chrono::duration_cast<std::chrono::hours>(elapsed).count() % 24;
+        if ((hour >= 6 && hour < 9) || (hour >= 17 && hour < 21))
+            return 6.0;
+        else if (hour >= 9 && hour < 17)
+            return 2.5;
+        else
+            return 1.0;
+    }
+
+    /**
+    * Moves the simulated plant on by one tick: the drive adds ten units a minute at 60Hz.
+    */
+    void simulate(chrono::duration_t elapsed)
+    {
+        double const minutes = std::chrono::duration<double, std::ratio<60>>(tick).count();
+        double const frequency = host::drive_registers[io::reg_frequency.address];
+        bool const running = host::drive_registers[io::reg_run.address] == io::run_args.run;
+        double const supply = running ? frequency / 6000.0 * 10.0 : 0.0;
+
+        pressure += (supply - demand(elapsed)) * minutes;
+        pressure = std::clamp(pressure, 0.0, 1000.0);
+        host::drive_registers[io::reg_pressure.address] = static_cast<uint16_t>(pressure);
+
+        bool const wet_sensor = (elapsed % flood_every) >= 3h && (elapsed % flood_every) < 3h + flood_wet;
+        host::drive_registers[io::reg_flood.address] = wet_sensor ? wet : dry;
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_year_of_operation()
+{
+    host::drive_registers.clear();
+    host::drive_registers[io::reg_pressure.address] = static_cast<uint16_t>(pressure);
+    host::drive_registers[io::reg_flood.address] = dry;
+
+    logger.set_level(io::level_t::error);
+    modbus.connect(io::connection_args_t{ .id = io::modbus_id, .serial = serial, .turnaround_ms = 0u });
+    pump.on_sample(record);
+    pump.begin(control::args_t
+    {
+        .modbus = &modbus,
+        .run_reg = io::reg_run,
+        .frequency_reg = io::reg_frequency,
+        .pressure = io::reg_pressure,
+        .flood = io::reg_flood,
+        .levels = io::stepper_levels,
+        .run_args = io::run_args,
+        .flood_trigger_value = io::flood_trigger,
+        .flood_timeout = io::flood_timeout
+    });
+
+    auto const start = rtc_time.now();
+    events.schedule(chrono::event_t{ handle_pump_update, start + tick });
+    for (auto elapsed = chrono::duration_t::zero(); elapsed < year; )
+    {
+        simulate(elapsed);
+        chrono::virtual_clock_t::advance(tick);
+        elapsed += tick;
+        events.process_events(rtc_time.now());
+    }
+
+    TEST_ASSERT_TRUE(rtc_time.now() - start == year);
+    TEST_ASSERT_EQUAL_UINT32(year / tick, stats.updates);
+    TEST_ASSERT_EQUAL_UINT32(0u, stats.mismatched);
+
+    // Pressure stays between the start and stop levels, give or take a tick of flow.
+    TEST_ASSERT_LESS_OR_EQUAL_UINT16(io::stepper_levels.stop.pressure + 2u, stats.max_pressure);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT16(io::stepper_levels.start.pressure - 2u, stats.min_dry_pressure);
+    TEST_ASSERT_GREATER_THAN_UINT32(365u * 5u, stats.starts);
+
+    // Every monthly flood stops the pump for the full timeout, after which it runs again.
+    TEST_ASSERT_EQUAL_UINT32(year / flood_every + 1u, stats.floods);
+    TEST_ASSERT_EQUAL_UINT32(0u, stats.flooded_running);
+    TEST_ASSERT_TRUE(stats.shortest_hold >= io::flood_timeout);
+    TEST_ASSERT_TRUE(stats.longest_hold <= io::flood_timeout + tick);
+}
+
+void test_clock_starts_at_epoch()
+{
+    chrono::virtual_clock_t::advance(90min);
+    chrono::monotonic_clock_t late{ chrono::virtual_clock_t::millis };
+
+    // Time before the first reading does not count.
+    chrono::virtual_clock_t::advance(5s);
+    TEST_ASSERT_TRUE(late.now() == chrono::from_monotonic(chrono::start_time));
+    chrono::virtual_clock_t::advance(1s);
+    TEST_ASSERT_TRUE(late.now() == chrono::from_monotonic(chrono::start_time) + 1s);
+
+    // The 32-bit micros() count wraps every ~71 minutes, the 64-bit one does not.
+    chrono::high_resolution_clock_t fine{ chrono::virtual_clock_t::micros };
+    chrono::virtual_clock_t::advance(5s);
+    int64_t const epoch = fine.micros();
+    TEST_ASSERT_EQUAL_INT64(chrono::start_time.milliseconds * 1000, epoch);
+    for (int i = 0; i != 3; ++i)
+    {
+        chrono::virtual_clock_t::advance(1h);
+        fine.micros();
+    }
+    TEST_ASSERT_EQUAL_INT64(epoch + 3 * 3600000000ll, fine.micros());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clock_starts_at_epoch);
+    RUN_TEST(test_year_of_operation);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Collapsing repeated modbus errors: repeats within the window are only counted, the count comes back as a summary
+* once the window closes, sites and errors are kept apart, and a full table gives up its oldest entry.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <unity.h>
+
+#include "repeat_filter.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    constexpr char const *file = "modbus_io.cpp";
+    constexpr io::modbus_error_t timeout = io::modbus_error_t::response_timeout;
+
+    io::repeat_filter_t filter;
+    std::vector<io::repeat_summary_t> summaries;
+
+    io::log_site_t site(uint16_t line)
+    {
+        return io::log_site_t{ file, line };
+    }
+
+    bool pass(io::modbus_error_t error, uint16_t line, int64_t now_ms)
+    {
+        return filter.pass(error, site(line), now_ms, [](io::repeat_summary_t const &s) { summaries.push_back(s); });
+    }
+
+    void expire(int64_t now_ms)
+    {
+        filter.expire(now_ms, [](io::repeat_summary_t const &s) { summaries.push_back(s); });
+    }
+}
+
+void setUp()
+{
+    filter = io::repeat_filter_t{};
+    summaries.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_repeats_are_counted_until_the_window_closes()
+{
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 0));
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 1000));
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 2500));
+
+    expire(59999);
+    TEST_ASSERT_EQUAL_size_t(0u, summaries.size());
+
+    // Two repeats over 2.5 s, summarized once the window has closed.
+    expire(60000);
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+    TEST_ASSERT_TRUE(summaries[0].error == timeout);
+    TEST_ASSERT_EQUAL_UINT16(100u, summaries[0].site.line);
+    TEST_ASSERT_EQUAL_UINT32(2u, summaries[0].count);
+    TEST_ASSERT_EQUAL_INT64(2500, summaries[0].duration_ms);
+
+    // The slot is free again, so the next one is let through.
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 61000));
+    expire(200000);
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+}
+
+void test_next_window_starts_with_a_summary()
+{
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 0));
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 10000));
+
+    // Let through once the window is over, with the count of the one before it.
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 60000));
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+    TEST_ASSERT_EQUAL_UINT32(1u, summaries[0].count);
+    TEST_ASSERT_EQUAL_INT64(10000, summaries[0].duration_ms);
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 60001));
+
+    // A window without repeats has nothing to summarize.
+    TEST_ASSERT_TRUE(pass(io::modbus_error_t::invalid_crc, 100u, 0));
+    TEST_ASSERT_TRUE(pass(io::modbus_error_t::invalid_crc, 100u, 60000));
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+}
+
+void test_window_is_configurable()
+{
+    filter.set_window(5s);
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 0));
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 4999));
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 5000));
+}
+
+void test_sites_and_errors_are_kept_apart()
+{
+    TEST_ASSERT_TRUE(pass(timeout, 100u, 0));
+    TEST_ASSERT_TRUE(pass(timeout, 200u, 0));
+    TEST_ASSERT_TRUE(pass(io::modbus_error_t::invalid_crc, 100u, 0));
+    TEST_ASSERT_TRUE(filter.pass(timeout, io::log_site_t{ "pump_state.cpp", 100u }, 0, [](io::repeat_summary_t const&) {}));
+
+    TEST_ASSERT_FALSE(pass(timeout, 100u, 1));
+    TEST_ASSERT_FALSE(pass(timeout, 200u, 1));
+    TEST_ASSERT_FALSE(pass(io::modbus_error_t::invalid_crc, 100u, 1));
+}
+
+void test_full_table_reuses_oldest_slot()
+{
+    for (uint16_t i = 0u; i != io::repeat_filter_slots; ++i)
+        TEST_ASSERT_TRUE(pass(timeout, i, i));
+    TEST_ASSERT_FALSE(pass(timeout, 0u, 100));
+
+    // One site too many: the oldest entry is summarized early and its slot taken.
+    TEST_ASSERT_TRUE(pass(timeout, 1000u, 200));
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+    TEST_ASSERT_EQUAL_UINT16(0u, summaries[0].site.line);
+    TEST_ASSERT_EQUAL_UINT32(1u, summaries[0].count);
+    TEST_ASSERT_FALSE(pass(timeout, 1000u, 300));
+
+    // So a repeat from that site starts over, and takes the next oldest slot, which has nothing to summarize.
+    TEST_ASSERT_TRUE(pass(timeout, 0u, 400));
+    TEST_ASSERT_EQUAL_size_t(1u, summaries.size());
+    TEST_ASSERT_TRUE(pass(timeout, 1u, 500));
+}
+
+void test_live_keys_are_found_past_freed_slots()
+{
+    // Half the table expires, leaving free slots among and in front of the live keys.
+    for (uint16_t i = 0u; i != io::repeat_filter_slots; ++i)
+        TEST_ASSERT_TRUE(pass(timeout, i, i < io::repeat_filter_slots / 2u ? 0 : 30000));
+    expire(60000);
+
+    for (uint16_t i = io::repeat_filter_slots / 2u; i != io::repeat_filter_slots; ++i)
+        TEST_ASSERT_FALSE(pass(timeout, i, 61000));
+    for (uint16_t i = 0u; i != io::repeat_filter_slots / 2u; ++i)
+        TEST_ASSERT_TRUE(pass(timeout, i, 61000));
+    TEST_ASSERT_EQUAL_size_t(0u, summaries.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_repeats_are_counted_until_the_window_closes);
+    RUN_TEST(test_next_window_starts_with_a_summary);
+    RUN_TEST(test_window_is_configurable);
+    RUN_TEST(test_sites_and_errors_are_kept_apart);
+    RUN_TEST(test_full_table_reuses_oldest_slot);
+    RUN_TEST(test_live_keys_are_found_past_freed_slots);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The series recorder only buffers from the pump's sample handler; blocks reach the card from update().
+*/
+
+#include <chrono>
+#include <cstdint>
+
+#include <SD.h>
+#include <unity.h>
+
+#include "monotonic_clock.hpp"
+#include "pump_state.hpp"
+#include "series_format.hpp"
+#include "series_recorder.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    io::series_recorder_t recorder;
+    chrono::time_point_t now = chrono::from_monotonic(chrono::start_time);
+
+    void sample(uint16_t pressure)
+    {
+        now += 1s;
+        recorder.record(control::sample_t{ .time = now, .pressure = pressure, .run = 1u, .frequency = 6000u,
+            .running = true });
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_blocks_are_written_from_update()
+{
+    SD.clear();
+    recorder.begin(io::series_file_path, io::recorder_args_t{});
+    auto const &contents = SD.contents(io::series_file_path);
+
+    // Every sample moves the pressure past the deadband, but nothing reaches the card before update().
+    uint16_t pressure = 700u;
+    for (int i = 0; i != 20; ++i)
+        sample(pressure += 10u);
+    TEST_ASSERT_EQUAL_size_t(0u, contents.size());
+
+    recorder.update(now);
+    TEST_ASSERT_EQUAL_size_t(io::series_block_size, contents.size());
+
+    // The block being filled is rewritten once a minute, not on every update.
+    uint32_t const flushes = SD.flushes();
+    recorder.update(now + 1s);
+    TEST_ASSERT_EQUAL_UINT32(flushes, SD.flushes());
+
+    // Fill the block and start the next one.  The sample handler never writes either.
+    for (int i = 0; i != 400 && contents.size() == io::series_block_size; ++i)
+    {
+        sample(pressure = (pressure == 700u ? 800u : 700u));
+        TEST_ASSERT_EQUAL_size_t(io::series_block_size, contents.size());
+        recorder.update(now);
+    }
+    TEST_ASSERT_EQUAL_size_t(2u * io::series_block_size, contents.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_are_written_from_update);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side benchmark of input calibration.  Runs the same stream of raw readings through io::calibration_table_t
+* for a linear, an eight point piecewise and a cubic calibration, and through a direct evaluation of each in double
+* (a search for the segment, or the polynomial), then reports nanoseconds per sample and the table's worst error
+* against the direct value.  The table's cost should not depend on the kind of calibration.
+*
+* Build: g++ -std=gnu++17 -O2 -Iinclude tools/calibration_bench.cpp src/calibration.cpp -o calibration_bench
+* Usage: calibration_bench [iterations]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "calibration.hpp"
+
+namespace
+{
+    using io::calibration_kind_t;
+    using io::calibration_t;
+
+    std::vector<uint16_t> make_readings(std::size_t count, uint16_t raw_max)
+    {
+        std::vector<uint16_t> readings;
+        readings.reserve(count);
+        uint32_t state = 0x2545F491u;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            state ^= state << 13u;
+            state ^= state >> 17u;
+            state ^= state << 5u;
+            readings.push_back(static_cast<uint16_t>(state % (raw_max + 1u)));
+        }
+        return readings;
+    }
+
+    double line(io::calibration_point_t const &a, io::calibration_point_t const &b, double raw)
+    {
+        double const rise = static_cast<double>(b.value) - a.value;
+        return a.value + rise * (raw - a.raw) / (static_cast<double>(b.raw) - a.raw);
+    }
+
+    double direct(calibration_t const &cal, uint16_t reading)
+    {
+        double const raw = std::min(reading, cal.raw_max);
+        double value = raw;
+        switch (cal.kind)
+        {
+            case calibration_kind_t::linear:
+                value = line(cal.points[0], cal.points[1], raw);
+                break;
+            case calibration_kind_t::piecewise:
+            {
+                io::calibration_point_t const *first = cal.points.data();
+                io::calibration_point_t const *last = first + cal.count - 1u;
+                if (raw <= first->raw)
+                    value = first->value;
+                else if (raw >= last->raw)
+                    value = last->value;
+                else
+                {
+                    io::calibration_point_t const *next = std::upper_bound(first, last, raw,
+                        [](double r, io::calibration_point_t const &p) { return r < p.raw; });
+                    value = line(*(next - 1), *next, raw);
+                }
+                break;
+            }
+            case calibration_kind_t::polynomial:
+            {
+                double const t = raw / cal.raw_max;
+                value = 0.0;
+                for (std::size_t i = cal.count; i != 0u; --i)
+                    value = value * t + cal.coefficients[i - 1u];
+                break;
+            }
+            default:
+                break;
+        }
+        return std::clamp(value, 0.0, 65535.0);
+    }
+
+    template <class F>
+    double nanoseconds_per_sample(std::size_t iterations, std::size_t samples, F &&f)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != iterations; ++i)
+            f();
+        std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations * samples);
+    }
+
+    struct named_t
+    {
+        char const *name;
+        calibration_t cal;
+    };
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t const iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000u;
+    constexpr std::size_t samples = 4096u;
+
+    // A 4-20mA transducer read through a 10 bit analog input, in tenths of a psi.
+    named_t const calibrations[]
+    {
+        { "linear", calibration_t{ calibration_kind_t::linear, 2u, 1023u, {{ { 205u, 0u }, { 1023u, 1000u } }} } },
+        { "piecewise", calibration_t{ calibration_kind_t::piecewise, 8u, 1023u, {{ { 205u, 0u }, { 300u, 110u },
+            { 400u, 230u }, { 500u, 355u }, { 600u, 480u }, { 700u, 610u }, { 850u, 800u }, { 1023u, 1000u } }} } },
+        { "polynomial", calibration_t{ calibration_kind_t::polynomial, 4u, 1023u, {},
+            { -250, 1100, 180, -30 } } }
+    };
+
+    std::vector<uint16_t> const readings = make_readings(samples, 1023u);
+    volatile uint32_t sink = 0u;
+    for (named_t const &named : calibrations)
+    {
+        io::calibration_table_t table;
+        table.build(named.cal);
+
+        double worst = 0.0;
+        for (uint16_t raw = 0u; raw <= 1023u; ++raw)
+            worst = std::max(worst, std::abs(table(raw) - direct(named.cal, raw)));
+
+        double const table_ns = nanoseconds_per_sample(iterations, samples, [&]()
+        {
+            uint32_t sum = 0u;
+            for (uint16_t raw : readings)
+                sum += table(raw);
+            sink = sink + sum;
+        });
+
+        double const direct_ns = nanoseconds_per_sample(iterations, samples, [&]()
+        {
+            double sum = 0.0;
+            for (uint16_t raw : readings)
+                sum += direct(named.cal, raw);
+            sink = sink + static_cast<uint32_t>(sum);
+        });
+
+        std::printf("%-10s  table: %5.2f ns/sample  direct: %5.2f ns/sample  worst error: %.2f\n", named.name,
+            table_ns, direct_ns, worst);
+    }
+    return 0;
+}
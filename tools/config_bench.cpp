@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side benchmark of configuration parsing.  Parses a 1 KB configuration (CONFIG.JSN) and a 16 KB one (the same
+* settings followed by notes the controller does not read) the way read_config used to, into an unbounded
+* JsonDocument on the heap, and the way it does now, through config_filter into a json_arena_t.  Reports the parse
+* time and the peak memory each took.  Host pointers are twice the size of the R4's, so the peaks overstate what
+* the device needs; the device logs its own as "config arena peak".
+*
+* Build: g++ -std=gnu++17 -O2 -Iinclude -I.pio/libdeps/UNOR4/ArduinoJson/src tools/config_bench.cpp
+*            src/json_arena.cpp -o config_bench
+* Usage: config_bench [CONFIG.JSN] [iterations]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ArduinoJson.h>
+
+#include "config_filter.hpp"
+#include "json_arena.hpp"
+
+namespace
+{
+    /**
+    * The heap, with the peak number of bytes in use tracked.
+    */
+    class counting_allocator_t : public ArduinoJson::Allocator
+    {
+    public:
+        void* allocate(std::size_t size) override
+        {
+            auto *block = static_cast<std::size_t*>(std::malloc(sizeof(std::max_align_t) + size));
+            if (block == nullptr)
+                return nullptr;
+            *block = size;
+            add(static_cast<std::ptrdiff_t>(size));
+            return reinterpret_cast<uint8_t*>(block) + sizeof(std::max_align_t);
+        }
+
+        void deallocate(void *ptr) override
+        {
+            if (ptr == nullptr)
+                return;
+            auto *block = reinterpret_cast<std::size_t*>(static_cast<uint8_t*>(ptr) - sizeof(std::max_align_t));
+            add(-static_cast<std::ptrdiff_t>(*block));
+            std::free(block);
+        }
+
+        void* reallocate(void *ptr, std::size_t size) override
+        {
+            if (ptr == nullptr)
+                return allocate(size);
+            auto *block = reinterpret_cast<std::size_t*>(static_cast<uint8_t*>(ptr) - sizeof(std::max_align_t));
+            std::size_t const old_size = *block;
+            block = static_cast<std::size_t*>(std::realloc(block, sizeof(std::max_align_t) + size));
+            if (block == nullptr)
+                return nullptr;
+            *block = size;
+            add(static_cast<std::ptrdiff_t>(size) - static_cast<std::ptrdiff_t>(old_size));
+            return reinterpret_cast<uint8_t*>(block) + sizeof(std::max_align_t);
+        }
+
+        std::size_t in_use = 0u;
+        std::size_t peak = 0u;
+
+    private:
+        void add(std::ptrdiff_t bytes)
+        {
+            in_use = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(in_use) + bytes);
+            peak = std::max(peak, in_use);
+        }
+    };
+
+    struct result_t
+    {
+        double microseconds = 0.0;
+        std::size_t peak = 0u;
+        bool ok = false;
+    };
+
+    template <class F>
+    double microseconds_per_parse(std::size_t iterations, F &&f)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != iterations; ++i)
+            f();
+        std::chrono::duration<double, std::micro> const elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    result_t parse_unbounded(std::string const &json, std::size_t iterations)
+    {
+        counting_allocator_t heap;
+        result_t result;
+        result.microseconds = microseconds_per_parse(iterations, [&]()
+        {
+            JsonDocument doc{ &heap };
+            result.ok = !deserializeJson(doc, json.data(), json.size());
+        });
+        result.peak = heap.peak;
+        return result;
+    }
+
+    result_t parse_filtered(std::string const &json, std::size_t iterations, std::size_t arena_size)
+    {
+        std::vector<std::max_align_t> buffer((arena_size + sizeof(std::max_align_t) - 1u) / sizeof(std::max_align_t));
+        io::json_arena_t arena{ buffer.data(), arena_size };
+        result_t result;
+        result.microseconds = microseconds_per_parse(iterations, [&]()
+        {
+            arena.reset();
+            JsonDocument filter{ &arena };
+            JsonDocument doc{ &arena };
+            DeserializationError error = deserializeJson(filter, io::config_filter.data(), io::config_filter.size());
+            if (!error)
+                error = deserializeJson(doc, json.data(), json.size(), DeserializationOption::Filter(filter));
+            result.ok = !error;
+        });
+        result.peak = arena.peak();
+        return result;
+    }
+
+    std::string pad_with_notes(std::string json, std::size_t size)
+    {
+        // Notes such as a user might keep in the file: read by the parser, but never needed.
+        std::size_t const close = json.rfind('}');
+        std::string notes = ",\n    \"notes\" :\n    [\n";
+        for (int i = 0; notes.size() + close < size - 64u; ++i)
+        {
+            notes += (i == 0 ? "        " : ",\n        ");
+            notes += "{ \"date\" : \"2025-06-" + std::to_string(10 + i % 20) + "\", \"text\" : \"raised fill pressure by " +
+                std::to_string(i % 9) + " after checking the tank pre-charge\" }";
+        }
+        notes += "\n    ]\n";
+        return json.substr(0u, close) + notes + json.substr(close);
+    }
+
+    void report(char const *name, std::string const &json, std::size_t iterations)
+    {
+        result_t const unbounded = parse_unbounded(json, iterations);
+        result_t const filtered = parse_filtered(json, iterations, 1u << 20u);
+        result_t const fixed = parse_filtered(json, 1u, io::config_arena_size);
+
+        std::printf("%s config, %zu bytes\n", name, json.size());
+        std::printf("  unbounded JsonDocument: %8.1f us, peak %6zu bytes%s\n", unbounded.microseconds, unbounded.peak,
+            unbounded.ok ? "" : " (failed)");
+        std::printf("  filtered into arena:    %8.1f us, peak %6zu bytes%s\n", filtered.microseconds, filtered.peak,
+            filtered.ok ? "" : " (failed)");
+        std::printf("  %zu byte arena:         %s\n", io::config_arena_size, fixed.ok ? "fits" : "NoMemory");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    char const *path = argc > 1 ? argv[1] : "CONFIG.JSN";
+    std::size_t const iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000u;
+
+    std::ifstream in{ path, std::ios::binary };
+    if (!in)
+    {
+        std::printf("cannot open %s\n", path);
+        return 1;
+    }
+    std::string const json{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+
+    report("1 KB", json, iterations);
+    report("16 KB", pad_with_notes(json, 16u * 1024u), iterations);
+    return 0;
+}
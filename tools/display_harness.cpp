@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side harness for the LED matrix display.  Runs io::display_t against a scripted minute of pump readings and
+* faults on a simulated 10 ms main loop, capturing every frame it produces, then reports frames rendered, time
+* spent rendering and the latency from set() to the first visible frame of a fault and of a pressure change.
+* The captured frames can be saved as a golden sequence, compared with one, or exported as a PGM film strip.
+*
+* Build: g++ -std=gnu++17 -O2 -Itools/host -Iinclude -Ilib/ArduinoGraphics/src
+*            -I".pio/libdeps/UNOR4/Embedded Template Library/include" tools/display_harness.cpp src/display.cpp
+*            src/matrix_sink.cpp src/message_queue.cpp src/frame_cache.cpp src/scroll_canvas.cpp
+*            src/monotonic_clock.cpp lib/ArduinoGraphics/src/ArduinoGraphics.cpp lib/ArduinoGraphics/src/Image.cpp
+*            -x c lib/ArduinoGraphics/src/Font_5x7.c -x c lib/ArduinoGraphics/src/Font_4x6.c -o display_harness
+* Usage: display_harness [scroll|dashboard] [--record golden.txt | --compare golden.txt] [--pgm frames.pgm]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "display.hpp"
+#include "log_format.hpp"
+#include "scroll_canvas.hpp"
+
+namespace chrono
+{
+    uint32_t hardware_millis() noexcept { return steady_millis(); }
+    uint32_t hardware_micros() noexcept { return steady_micros(); }
+}
+
+namespace
+{
+    using std::chrono::milliseconds;
+
+    constexpr milliseconds loop_period{ 10 };
+    constexpr milliseconds script_length{ 60000 };
+    constexpr milliseconds reading_period{ 1000 };
+    constexpr milliseconds fault_at{ 20000 };
+    constexpr milliseconds pressure_step_at{ 40000 };
+
+    constexpr io::register_t reg_run{ 0x2501 };
+    constexpr io::register_t reg_frequency{ 0x2502 };
+    constexpr io::register_t reg_pressure{ 0x0C1A };
+
+    io::display_t display;
+
+    /**
+    * A message whose latency is measured: from set() to the first visible frame showing it.  A scrolled message is
+    * recognised by its frames, rendered here the way the display renders them; a dashboard change is the first
+    * still frame drawn after it.
+    */
+    struct probe_t
+    {
+        std::optional<chrono::time_point_t> set;
+        std::optional<chrono::time_point_t> visible;
+        std::size_t from = 0u;
+        std::vector<io::matrix_sink_t::captured_t> expected;
+    };
+
+    void expect_scroll(probe_t &probe, char const *text)
+    {
+        static io::scroll_canvas_t canvas;
+        static io::frame_t frames[200];
+        uint32_t const bytes = canvas.render(text, Font_5x7, 100u, frames, sizeof(frames));
+        for (uint32_t i = 0u; i != bytes / sizeof(io::frame_t); ++i)
+            probe.expected.push_back(io::matrix_sink_t::captured_t{ { frames[i][0], frames[i][1], frames[i][2] }, {}, frames[i][3] });
+    }
+
+    bool same(io::matrix_sink_t::captured_t const &a, io::matrix_sink_t::captured_t const &b)
+    {
+        return a.pixels == b.pixels && a.duration_ms == b.duration_ms;
+    }
+
+    void resolve(probe_t &probe, io::matrix_sink_t const &sink)
+    {
+        if (!probe.set || probe.visible)
+            return;
+
+        auto const &frames = sink.frames();
+        for (std::size_t i = probe.from; i < frames.size(); ++i)
+        {
+            if (probe.expected.empty())
+            {
+                if (frames[i].duration_ms == 0u)
+                {
+                    probe.visible = frames[i].visible;
+                    return;
+                }
+                continue;
+            }
+
+            if (frames.size() - i >= probe.expected.size() &&
+                std::equal(probe.expected.begin(), probe.expected.end(), frames.begin() + i, same))
+            {
+                probe.visible = frames[i].visible;
+                return;
+            }
+        }
+    }
+
+    void print_latency(char const *name, probe_t const &probe)
+    {
+        if (probe.visible)
+        {
+            auto const ms = std::chrono::duration_cast<milliseconds>(*probe.visible - *probe.set).count();
+            std::printf("%s: set() to first visible frame %lld ms\n", name, static_cast<long long>(ms));
+        }
+        else
+        {
+            std::printf("%s: never shown\n", name);
+        }
+    }
+
+    double microseconds(std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    io::display_args_t args;
+    char const *record = nullptr;
+    char const *compare = nullptr;
+    char const *pgm = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg{ argv[i] };
+        if (auto mode = io::parse_display_mode(arg))
+            args.mode = *mode;
+        else if (arg == "--record" && i + 1 < argc)
+            record = argv[++i];
+        else if (arg == "--compare" && i + 1 < argc)
+            compare = argv[++i];
+        else if (arg == "--pgm" && i + 1 < argc)
+            pgm = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [scroll|dashboard] [--record file | --compare file] [--pgm file]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    chrono::time_point_t const start{};
+    display.begin(start);
+    display.configure(args);
+    io::matrix_sink_t &sink = display.sink();
+
+    probe_t fault;
+    probe_t pressure;
+    expect_scroll(fault, "  modbus error: response timeout");
+    if (args.mode == io::display_mode_t::scroll)
+        expect_scroll(pressure, "  pressure: 790");
+    std::chrono::steady_clock::duration busy{};
+    std::chrono::steady_clock::duration worst{};
+    uint32_t updates = 0u;
+
+    for (milliseconds t{ 0 }; t < script_length; t += loop_period)
+    {
+        chrono::time_point_t const now = start + t;
+        sink.set_time(now);
+
+        // A sequence ends once its last frame has been shown for its duration.
+        auto const &frames = sink.frames();
+        if (!frames.empty() && frames.back().duration_ms != 0u &&
+            now >= frames.back().visible + milliseconds{ frames.back().duration_ms })
+        {
+            sink.complete();
+        }
+
+        if (t % reading_period == milliseconds{ 0 })
+        {
+            // Pressure wanders between 810 and 813 and steps down to 790 part way through.
+            uint64_t const p = t >= pressure_step_at ? 790u : 810u + (t / reading_period) % 4u;
+            if (t == pressure_step_at)
+            {
+                pressure.set = now;
+                pressure.from = frames.size();
+            }
+            display.set(io::value_msg_t{ LOG_MSG("run: "), reg_run, 1u });
+            display.set(io::value_msg_t{ LOG_MSG("frequency: "), reg_frequency, p < 800u ? 6000u : 5400u });
+            display.set(io::value_msg_t{ LOG_MSG("pressure: "), reg_pressure, p });
+        }
+        if (t == fault_at)
+        {
+            fault.set = now;
+            fault.from = frames.size();
+            display.set(io::modbus_error_t::response_timeout);
+        }
+
+        auto const before = std::chrono::steady_clock::now();
+        display.update(now);
+        auto const spent = std::chrono::steady_clock::now() - before;
+        busy += spent;
+        worst = std::max(worst, spent);
+        ++updates;
+
+        resolve(fault, sink);
+        resolve(pressure, sink);
+    }
+
+    auto const &frames = sink.frames();
+    std::printf("mode: %s, frames: %zu, updates: %u\n", args.mode == io::display_mode_t::dashboard ? "dashboard" : "scroll",
+        frames.size(), updates);
+    std::printf("update: %.1f us total, %.2f us mean, %.1f us worst\n", microseconds(busy), microseconds(busy) / updates,
+        microseconds(worst));
+    print_latency("fault", fault);
+    print_latency("pressure change", pressure);
+
+    if (pgm != nullptr)
+    {
+        std::ofstream out{ pgm };
+        io::write_pgm(out, frames);
+    }
+
+    if (record != nullptr)
+    {
+        std::ofstream out{ record };
+        io::write_ascii(out, frames);
+        std::printf("recorded %zu frames to %s\n", frames.size(), record);
+    }
+
+    if (compare != nullptr)
+    {
+        std::ifstream golden{ compare };
+        if (!golden)
+        {
+            std::fprintf(stderr, "cannot open %s\n", compare);
+            return EXIT_FAILURE;
+        }
+        if (auto differs = io::compare_ascii(golden, frames))
+        {
+            std::printf("frame %zu differs from %s\n", *differs, compare);
+            return EXIT_FAILURE;
+        }
+        std::printf("matches %s\n", compare);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side benchmark of number formatting.  Formats the same stream of values through a replica of Arduino's
+* Print::print(unsigned long) (a division per digit and a virtual write() per character) and through
+* io::format_decimal/io::text_writer_t, checks both against std::to_string, and reports nanoseconds per number.
+* Ten runs with g++ 12.2 at -O2 on an x86-64 host gave 24-27 ns for Print::print and 19-22 ns for text_writer_t,
+* between 1.1x and 1.3x faster from run to run; the ratio on the device is not measured.
+*
+* Build: g++ -std=gnu++17 -O2 -Iinclude tools/format_bench.cpp -o format_bench
+* Usage: format_bench [iterations]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "number_format.hpp"
+
+namespace
+{
+    /**
+    * The parts of Arduino's Print that print a number, as shipped in the Renesas core.
+    */
+    class print_t
+    {
+    public:
+        virtual ~print_t() = default;
+        virtual std::size_t write(uint8_t) = 0;
+
+        std::size_t write(char const *str)
+        {
+            std::size_t n = 0u;
+            while (*str != '\0')
+                n += write(static_cast<uint8_t>(*str++));
+            return n;
+        }
+
+        std::size_t print(char const *str)  { return write(str); }
+        std::size_t print(unsigned long n)  { return print_number(n, 10u); }
+        std::size_t print(long n)
+        {
+            if (n < 0)
+                return write('-') + print_number(0ul - static_cast<unsigned long>(n), 10u);
+            return print_number(static_cast<unsigned long>(n), 10u);
+        }
+
+    private:
+        std::size_t print_number(unsigned long n, uint8_t base)
+        {
+            char buf[8 * sizeof(long) + 1];
+            char *str = &buf[sizeof(buf) - 1];
+            *str = '\0';
+            do
+            {
+                char const c = static_cast<char>(n % base);
+                n /= base;
+                *--str = static_cast<char>(c < 10 ? c + '0' : c + 'A' - 10);
+            } while (n != 0u);
+            return write(str);
+        }
+    };
+
+    class capture_t : public print_t
+    {
+    public:
+        using print_t::write;
+        std::size_t write(uint8_t c) override
+        {
+            text.push_back(static_cast<char>(c));
+            return 1u;
+        }
+
+        std::string text;
+    };
+
+    std::vector<uint32_t> make_values(std::size_t count)
+    {
+        // Mostly register sized readings, with the odd counter or millisecond total.
+        std::vector<uint32_t> values;
+        values.reserve(count);
+        uint32_t state = 0x2545F491u;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            state ^= state << 13u;
+            state ^= state >> 17u;
+            state ^= state << 5u;
+            values.push_back((i % 8u) == 0u ? state : state % 65536u);
+        }
+        return values;
+    }
+
+    template <class F>
+    double nanoseconds_per_number(std::size_t iterations, std::size_t numbers, F &&f)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != iterations; ++i)
+            f();
+        std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations * numbers);
+    }
+
+    bool verify()
+    {
+        char buffer[io::max_number_chars];
+        auto check = [&](auto value)
+        {
+            char *end = io::format_decimal(buffer, buffer + sizeof(buffer), value);
+            return end != nullptr && std::string(buffer, end) == std::to_string(value);
+        };
+
+        bool passed = check(std::numeric_limits<uint64_t>::max()) && check(std::numeric_limits<int64_t>::min()) &&
+            check(std::numeric_limits<int32_t>::min()) && check(0);
+        for (uint64_t v = 1u; v <= std::numeric_limits<uint64_t>::max() / 10u; v *= 10u)
+            passed = passed && check(v - 1u) && check(v) && check(v + 1u);
+        for (uint32_t v = 0u; v != 100000u; ++v)
+            passed = passed && check(v) && check(-static_cast<int32_t>(v));
+
+        char *end = io::format_fixed(buffer, buffer + sizeof(buffer), 6000, 2u);
+        passed = passed && std::string(buffer, end) == "60.00";
+        end = io::format_fixed(buffer, buffer + sizeof(buffer), -5, 2u);
+        passed = passed && std::string(buffer, end) == "-0.05";
+        return passed;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t const iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200u;
+    constexpr std::size_t numbers = 4096u;
+    std::vector<uint32_t> const values = make_values(numbers);
+
+    if (!verify())
+    {
+        std::printf("format_decimal disagrees with std::to_string\n");
+        return 1;
+    }
+
+    capture_t print;
+    print.text.reserve(numbers * 12u);
+    std::string writer_text;
+    writer_text.reserve(numbers * 12u);
+
+    // One stats line per number, as the dumps print them: a label then the value.
+    double const print_ns = nanoseconds_per_number(iterations, numbers, [&]()
+    {
+        print.text.clear();
+        for (uint32_t v : values)
+        {
+            print.print("n=");
+            print.print(static_cast<unsigned long>(v));
+        }
+    });
+
+    double const writer_ns = nanoseconds_per_number(iterations, numbers, [&]()
+    {
+        writer_text.clear();
+        for (uint32_t v : values)
+        {
+            char buffer[32];
+            io::text_writer_t line(buffer, sizeof(buffer));
+            line.append("n=").append(v);
+            writer_text.append(line.c_str(), line.size());
+        }
+    });
+
+    if (print.text != writer_text)
+    {
+        std::printf("outputs differ\n");
+        return 1;
+    }
+
+    std::printf("numbers: %zu x %zu, %zu chars\n", iterations, numbers, writer_text.size());
+    std::printf("Print::print:   %.1f ns/number\n", print_ns);
+    std::printf("text_writer_t:  %.1f ns/number (%.2fx)\n", writer_ns, print_ns / writer_ns);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Just enough of the Arduino core to build the controller's sources into host side tools and the native tests.
+* Time comes from the host's steady clock, pins do nothing and analog inputs read back whatever a test set them to.
+*/
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using std::abs;
+using std::sqrt;
+
+using pin_size_t = uint8_t;
+
+enum : pin_size_t { A0 = 14u, A1, A2, A3, A4, A5 };
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+inline unsigned long micros()
+{
+    auto const since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count());
+}
+
+inline unsigned long millis()
+{
+    auto const since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+}
+
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void pinMode(pin_size_t, int) {}
+inline void digitalWrite(pin_size_t, int) {}
+
+namespace host
+{
+    inline std::array<int, A5 + 1u> analog_inputs{};
+}
+
+inline int analogRead(pin_size_t pin)
+{
+    return pin < host::analog_inputs.size() ? host::analog_inputs[pin] : 0;
+}
+
+class String
+{
+public:
+    String(char const *s = "") : s_(s) {}
+
+    String& operator+=(char c)          { s_ += c; return *this; }
+    unsigned length() const             { return static_cast<unsigned>(s_.size()); }
+    char const* c_str() const           { return s_.c_str(); }
+
+private:
+    std::string s_;
+};
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(uint8_t const *buffer, size_t size)
+    {
+        size_t n = 0u;
+        while (size-- != 0u)
+            n += write(*buffer++);
+        return n;
+    }
+    virtual void flush() {}
+
+    size_t print(char const *s)
+    {
+        size_t n = 0u;
+        while (*s)
+            n += write(static_cast<uint8_t>(*s++));
+        return n;
+    }
+
+    size_t print(unsigned long long v)  { return print(std::to_string(v).c_str()); }
+    size_t println(char const *s)       { return print(s) + print("\r\n"); }
+    size_t println(unsigned long long v){ return print(v) + print("\r\n"); }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(char *buffer, size_t length)
+    {
+        size_t count = 0u;
+        for (int c; count != length && (c = read()) >= 0; ++count)
+            buffer[count] = static_cast<char>(c);
+        return count;
+    }
+
+    size_t readBytes(uint8_t *buffer, size_t length)
+    {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+};
+
+#endif // HOST_ARDUINO_H_
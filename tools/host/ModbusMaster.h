@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* The parts of the ModbusMaster library the controller uses, for host side tools and the native tests.  Instead of
+* talking to a drive it reads and writes a simulated one: host::drive_registers, which every ModbusMaster shares.
+* Setting host::drive_error makes every transaction fail with that code until it is cleared.
+*/
+
+#ifndef HOST_MODBUS_MASTER_H_
+#define HOST_MODBUS_MASTER_H_
+
+#include <cstdint>
+#include <map>
+
+#include <Arduino.h>
+
+namespace host
+{
+    inline std::map<uint16_t, uint16_t> drive_registers;
+    inline uint8_t drive_error = 0u;
+    inline uint32_t drive_writes = 0u;
+}
+
+class ModbusMaster
+{
+public:
+    static constexpr uint8_t ku8MBSuccess = 0x00;
+    static constexpr uint8_t ku8MBIllegalFunction = 0x01;
+    static constexpr uint8_t ku8MBIllegalDataAddress = 0x02;
+    static constexpr uint8_t ku8MBIllegalDataValue = 0x03;
+    static constexpr uint8_t ku8MBSlaveDeviceFailure = 0x04;
+    static constexpr uint8_t ku8MBInvalidSlaveID = 0xE0;
+    static constexpr uint8_t ku8MBInvalidFunction = 0xE1;
+    static constexpr uint8_t ku8MBResponseTimedOut = 0xE2;
+    static constexpr uint8_t ku8MBInvalidCRC = 0xE3;
+
+    void begin(uint8_t, Stream&)                    {}
+    void preTransmission(void (*)())                {}
+    void postTransmission(void (*)())               {}
+
+    uint8_t readHoldingRegisters(uint16_t address, uint16_t)
+    {
+        if (host::drive_error != ku8MBSuccess)
+            return host::drive_error;
+        response_ = host::drive_registers[address];
+        return ku8MBSuccess;
+    }
+
+    uint8_t writeSingleRegister(uint16_t address, uint16_t value)
+    {
+        if (host::drive_error != ku8MBSuccess)
+            return host::drive_error;
+        host::drive_registers[address] = value;
+        ++host::drive_writes;
+        return ku8MBSuccess;
+    }
+
+    uint16_t getResponseBuffer(uint8_t) const       { return response_; }
+    void clearResponseBuffer()                      { response_ = 0u; }
+
+private:
+    uint16_t response_ = 0u;
+};
+
+#endif // HOST_MODBUS_MASTER_H_
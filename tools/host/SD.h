@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* An in-memory stand-in for the Arduino SD library, for the native tests.  Files live in SD's map for the life of
+* the program and every File open on one shares its contents, as on a card.  set_full() makes creating a new file
+* fail, the way a full card does.
+*/
+
+#ifndef HOST_SD_H_
+#define HOST_SD_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+
+#define O_READ 0x01
+#define O_RDONLY O_READ
+#define O_WRITE 0x02
+#define O_WRONLY O_WRITE
+#define O_RDWR (O_READ | O_WRITE)
+#define O_APPEND 0x04
+#define O_CREAT 0x10
+#define O_TRUNC 0x40
+#define FILE_READ O_READ
+#define FILE_WRITE (O_READ | O_WRITE | O_CREAT | O_APPEND)
+
+namespace SDLib
+{
+    using contents_t = std::vector<uint8_t>;
+
+    inline uint32_t file_flushes = 0u;
+
+    class File : public Stream
+    {
+    public:
+        File() = default;
+        File(std::shared_ptr<contents_t> contents, uint8_t mode) : contents_(std::move(contents)), mode_(mode) {}
+
+        using Print::write;
+        size_t write(uint8_t b) override                { return write(&b, 1u); }
+        size_t write(uint8_t const *buffer, size_t size) override
+        {
+            if (!contents_ || (mode_ & O_WRITE) == 0u)
+                return 0u;
+
+            if ((mode_ & O_APPEND) != 0u)
+                position_ = static_cast<uint32_t>(contents_->size());
+            if (contents_->size() < position_ + size)
+                contents_->resize(position_ + size);
+            std::copy_n(buffer, size, contents_->begin() + position_);
+            position_ += static_cast<uint32_t>(size);
+            return size;
+        }
+
+        int read() override
+        {
+            uint8_t b;
+            return read(&b, 1u) == 1 ? b : -1;
+        }
+
+        int read(void *buffer, uint16_t size)
+        {
+            if (!contents_)
+                return -1;
+
+            uint32_t const count = std::min<uint32_t>(size, available());
+            std::copy_n(contents_->begin() + position_, count, static_cast<uint8_t*>(buffer));
+            position_ += count;
+            return static_cast<int>(count);
+        }
+
+        int peek() override                             { return available() > 0 ? (*contents_)[position_] : -1; }
+        int available() override
+        {
+            return contents_ && position_ < contents_->size() ? static_cast<int>(contents_->size() - position_) : 0;
+        }
+
+        void flush() override                           { ++file_flushes; }
+        bool seek(uint32_t position)
+        {
+            if (!contents_ || position > contents_->size())
+                return false;
+            position_ = position;
+            return true;
+        }
+
+        uint32_t position() const                       { return position_; }
+        uint32_t size() const                           { return contents_ ? uint32_t(contents_->size()) : 0u; }
+        void close()                                    { contents_.reset(); }
+        operator bool() const                           { return static_cast<bool>(contents_); }
+
+    private:
+        std::shared_ptr<contents_t> contents_;
+        uint8_t mode_ = 0u;
+        uint32_t position_ = 0u;
+    };
+
+    class SDClass
+    {
+    public:
+        bool begin(uint8_t)                             { return true; }
+
+        File open(char const *name, uint8_t mode = FILE_READ)
+        {
+            auto itr = files_.find(name);
+            if (itr == files_.end())
+            {
+                if ((mode & O_CREAT) == 0u || full_)
+                    return File{};
+                itr = files_.emplace(name, std::make_shared<contents_t>()).first;
+            }
+            if ((mode & O_TRUNC) != 0u)
+                itr->second->clear();
+            return File{ itr->second, mode };
+        }
+
+        bool exists(char const *name) const             { return files_.count(name) != 0u; }
+        bool remove(char const *name)                   { return files_.erase(name) != 0u; }
+        bool mkdir(char const*)                         { return true; }
+
+        /** Contents of a file for a test to inspect or damage, empty if there is no such file. */
+        contents_t& contents(char const *name)
+        {
+            static contents_t none;
+            auto itr = files_.find(name);
+            return itr != files_.end() ? *itr->second : (none = contents_t{});
+        }
+
+        /** Flushes asked of any file, so tests can tell when a writer forces data out. */
+        uint32_t flushes() const                        { return file_flushes; }
+
+        void set_full(bool full)                        { full_ = full; }
+        void clear()                                    { files_.clear(); full_ = false; }
+
+    private:
+        std::map<std::string, std::shared_ptr<contents_t>> files_;
+        bool full_ = false;
+    };
+
+    inline SDClass SD;
+}
+
+using namespace SDLib;
+
+#endif // HOST_SD_H_
@@ -0,0 +1,285 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side decoder for the controller's binary log segments (PMPCTRL.000 ...), exporting one CSV row per record.
+* Segments are decoded in the order of their sequence numbers, whatever order they are given in.
+*
+* Build: g++ -std=c++17 -O2 -Iinclude tools/log_decode.cpp -o log_decode
+* Usage: log_decode PMPCTRL.0* > log.csv
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_format.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+    std::string_view record_name(io::record_t type) noexcept
+    {
+        switch (type)
+        {
+            case io::record_t::session: return "session";
+            case io::record_t::message: return "message";
+            case io::record_t::message_value: return "message_value";
+            case io::record_t::text: return "text";
+            case io::record_t::value: return "value";
+            case io::record_t::modbus_error: return "modbus_error";
+            case io::record_t::failure: return "failure";
+            case io::record_t::failure_text: return "failure_text";
+            case io::record_t::profile: return "profile";
+            case io::record_t::log_stats: return "log_stats";
+            case io::record_t::repeated: return "repeated";
+            case io::record_t::segment: return "segment";
+            default: return "unknown";
+        }
+    }
+
+    // Mirrors io::error_message(), which can't be included here as it depends on ModbusMaster.
+    std::string_view modbus_error_name(uint64_t code) noexcept
+    {
+        switch (code)
+        {
+            case 0x00: return "success";
+            case 0x01: return "illegal function";
+            case 0x02: return "illegal data address";
+            case 0x03: return "illegal data value";
+            case 0x04: return "slave device failure";
+            case 0xE0: return "invalid slave id";
+            case 0xE1: return "invalid function";
+            case 0xE2: return "response timeout";
+            case 0xE3: return "invalid crc";
+            default: return "unknown";
+        }
+    }
+
+    std::string csv_quote(std::string_view text)
+    {
+        std::string quoted{ '"' };
+        for (char c : text)
+        {
+            if (c == '"')
+                quoted += '"';
+            if (c != '\r' && c != '\n')
+                quoted += c;
+        }
+        quoted += '"';
+        return quoted;
+    }
+
+    std::string_view message(uint64_t id) noexcept
+    {
+        return io::message_text(static_cast<io::msg_id_t>(id));
+    }
+
+    struct row_t
+    {
+        std::string_view message;
+        std::string reg;
+        std::string value;
+        std::string detail;
+    };
+
+    row_t decode_fields(io::record_t type, io::record_reader_t &reader)
+    {
+        row_t row;
+        auto remaining_text = [&]()
+        {
+            return std::string_view{ reinterpret_cast<char const*>(reader.remaining()), reader.remaining_size() };
+        };
+
+        switch (type)
+        {
+            case io::record_t::message:
+            case io::record_t::failure:
+                row.message = message(reader.get());
+                break;
+            case io::record_t::message_value:
+                row.message = message(reader.get());
+                row.value = std::to_string(reader.get());
+                break;
+            case io::record_t::text:
+            case io::record_t::failure_text:
+                row.detail = std::string{ remaining_text() };
+                break;
+            case io::record_t::value:
+                row.message = message(reader.get());
+                row.reg = std::to_string(reader.get());
+                row.value = std::to_string(reader.get());
+                break;
+            case io::record_t::modbus_error:
+            {
+                uint64_t const code = reader.get();
+                row.value = std::to_string(code);
+                row.detail = std::string{ modbus_error_name(code) };
+                if (!reader.at_end())
+                    row.detail += " line=" + std::to_string(reader.get());
+                break;
+            }
+            case io::record_t::repeated:
+            {
+                uint64_t const code = reader.get();
+                uint64_t const line = reader.get();
+                row.value = std::to_string(reader.get());
+                row.detail = std::string{ modbus_error_name(code) } + " line=" + std::to_string(line);
+                row.detail += " over_ms=" + std::to_string(reader.get());
+                break;
+            }
+            case io::record_t::profile:
+            {
+                row.message = chrono::scope_name(static_cast<chrono::scope_t>(reader.get()));
+                row.value = std::to_string(reader.get());
+                row.detail = "min=" + std::to_string(reader.get());
+                row.detail += " mean=" + std::to_string(reader.get());
+                row.detail += " max=" + std::to_string(reader.get());
+                row.detail += " hist=";
+                for (std::size_t i = 0; i != chrono::histogram_buckets; ++i)
+                    row.detail += (i == 0u ? "" : "/") + std::to_string(reader.get());
+                break;
+            }
+            case io::record_t::segment:
+                row.value = std::to_string(reader.get());
+                break;
+            case io::record_t::log_stats:
+                row.value = std::to_string(reader.get());
+                row.detail = "high_water=" + std::to_string(reader.get());
+                row.detail += " dropped=" + std::to_string(reader.get());
+                break;
+            default:
+                break;
+        }
+        return row;
+    }
+
+    struct segment_t
+    {
+        std::string path;
+        std::vector<uint8_t> data;
+        uint64_t sequence = 0u;
+    };
+
+    bool load(std::string const &path, segment_t &segment)
+    {
+        std::ifstream in{ path, std::ios::binary };
+        if (!in)
+        {
+            std::cerr << path << ": cannot open\n";
+            return false;
+        }
+
+        segment.path = path;
+        segment.data.assign(std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{});
+
+        std::vector<uint8_t> const &data = segment.data;
+        if (!data.empty() && data[0] == static_cast<uint8_t>(io::record_t::segment) && io::record_intact(data.data(), data.size()))
+        {
+            io::record_reader_t reader{ data.data() + io::record_header_size, data[1] };
+            reader.get();
+            segment.sequence = reader.get();
+        }
+        return true;
+    }
+
+    void decode(segment_t const &segment, std::ostream &out)
+    {
+        std::string const &path = segment.path;
+        std::vector<uint8_t> const &data = segment.data;
+        int64_t time = 0;
+        bool sequenced = false;
+        uint8_t sequence = 0u;
+        std::size_t offset = 0u;
+        while (offset < data.size())
+        {
+            io::record_t const type = static_cast<io::record_t>(data[offset]);
+            if (type == io::record_t::padding)
+            {
+                ++offset;
+                continue;
+            }
+
+            // Records never straddle a sector, so after a damaged one decoding picks up again at the next sector.
+            if (!io::record_intact(data.data() + offset, data.size() - offset))
+            {
+                std::cerr << path << ": damaged record at offset " << offset << '\n';
+                offset = (offset / io::sector_size + 1u) * io::sector_size;
+                sequenced = false;
+                continue;
+            }
+
+            uint8_t const next = data[offset + 2u];
+            if (sequenced && next != static_cast<uint8_t>(sequence + 1u))
+                std::cerr << path << ": sequence gap before offset " << offset << '\n';
+            sequenced = true;
+            sequence = next;
+
+            std::size_t const length = data[offset + 1u];
+            uint8_t const *payload = data.data() + offset + io::record_header_size;
+            offset += io::record_size(data[offset + 1u]);
+
+            io::record_reader_t reader{ payload, length };
+            uint64_t const stamp = reader.get();
+            time = io::absolute_time(type) ? static_cast<int64_t>(stamp) : time + static_cast<int64_t>(stamp);
+
+            row_t const row = decode_fields(type, reader);
+            out << time << ',' << record_name(type) << ',' << csv_quote(row.message) << ',' << row.reg << ','
+                << row.value << ',' << csv_quote(row.detail) << '\n';
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <log segment>...\n";
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::cout << "time_ms,record,message,register,value,detail\n";
+
+    bool ok = true;
+    std::vector<segment_t> segments;
+    for (int i = 1; i < argc; ++i)
+    {
+        segment_t segment;
+        if (load(argv[i], segment))
+            segments.push_back(std::move(segment));
+        else
+            ok = false;
+    }
+
+    std::stable_sort(segments.begin(), segments.end(), [](segment_t const &a, segment_t const &b)
+    {
+        return a.sequence < b.sequence;
+    });
+
+    for (segment_t const &segment : segments)
+        decode(segment, std::cout);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#!/bin/sh
+# Copyright (c) 2025 Ben McCart
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+# documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+# to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+# the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+# THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# What the compile-time log level saves in the pump update: builds src/pump_state.cpp for the host at -O2 against
+# the stand-ins in tools/host, once per PUMP_LOG_LEVEL, and prints the instructions in pump_t::update() and the
+# object's text size.  Host x86-64 code, so the numbers show the difference between levels, not flash on the board.
+#
+# Usage: tools/log_level_size.sh [levels...]     (default: 1 2, i.e. debug and info)
+# ETL_INCLUDE points at the Embedded Template Library headers, by default where `pio test -e native` installs them.
+
+set -e
+cd "$(dirname "$0")/.."
+ETL_INCLUDE=${ETL_INCLUDE:-".pio/libdeps/native/Embedded Template Library/include"}
+CXX=${CXX:-g++}
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+[ $# -eq 0 ] && set -- 1 2
+printf '%-16s %14s %10s\n' PUMP_LOG_LEVEL update_instrs text_bytes
+for level in "$@"; do
+    obj="$out/pump_state_$level.o"
+    $CXX -std=gnu++17 -O2 -DPUMP_LOG_LEVEL="$level" -Itools/host -I"$ETL_INCLUDE" -Iinclude -Ilib/ArduinoGraphics/src \
+        -c src/pump_state.cpp -o "$obj"
+    instructions=$(objdump -d --no-show-raw-insn -C "$obj" |
+        awk '/^[0-9a-f]+ <control::pump_t::update\(\)>:$/ { in_fn = 1; next } in_fn && /^$/ { exit }
+             in_fn && /^ *[0-9a-f]+:/ { n++ } END { print n + 0 }')
+    text=$(size -A "$obj" | awk '$1 ~ /^\.text/ { t += $2 } END { print t + 0 }')
+    printf '%-16s %14s %10s\n' "$level" "$instructions" "$text"
+done
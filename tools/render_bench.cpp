@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side benchmark of the LED matrix scroll rendering.  Reports the frames per second of a 40 character scroll
+* drawn through set() one pixel at a time against the packed glyph blitter, then renders the controller's typical
+* messages exactly as the display does and reports the cost per message with and without the frame cache.
+*
+* Build: g++ -std=gnu++17 -O2 -Itools/host -Iinclude -Ilib/ArduinoGraphics/src
+*            -I".pio/libdeps/UNOR4/Embedded Template Library/include" tools/render_bench.cpp src/frame_cache.cpp
+*            src/scroll_canvas.cpp
+*            lib/ArduinoGraphics/src/ArduinoGraphics.cpp lib/ArduinoGraphics/src/Image.cpp
+*            -x c lib/ArduinoGraphics/src/Font_5x7.c -x c lib/ArduinoGraphics/src/Font_4x6.c -o render_bench
+*        Add -D PUMP_FRAME_CACHE_FRAMES=<n> to try other pool sizes.
+* Usage: render_bench [iterations]
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArduinoGraphics.h"
+#include "frame_cache.hpp"
+#include "scroll_canvas.hpp"
+
+namespace
+{
+    using io::matrix_width;
+    using io::matrix_height;
+    constexpr uint32_t milliseconds_per_frame = 100u;
+
+    /**
+    * The renderer before the packed blitter: captures the same frames as io::scroll_canvas_t, but every pixel of
+    * every glyph goes through set() into a byte per pixel canvas that is packed at the end of each frame.
+    */
+    class pixel_canvas_t : public ArduinoGraphics
+    {
+    public:
+        pixel_canvas_t()
+        : ArduinoGraphics(matrix_width, matrix_height)
+        {
+            begin();
+        }
+
+        uint32_t render(char const *text, Font const &font, uint32_t, io::frame_t *frames, uint32_t bytes)
+        {
+            frames_ = frames;
+            remaining_ = bytes / sizeof(io::frame_t);
+            used_ = 0u;
+
+            stroke(0xFFFFFFFF);
+            textFont(font);
+            textScrollSpeed(0u);
+            beginText(0, 1, 0xFFFFFF);
+            println(text);
+            endText(SCROLL_LEFT);
+            return static_cast<uint32_t>(used_ * sizeof(io::frame_t));
+        }
+
+        void beginDraw() override
+        {
+            ArduinoGraphics::beginDraw();
+            std::memset(canvas_, 0, sizeof(canvas_));
+        }
+
+        void endDraw() override
+        {
+            ArduinoGraphics::endDraw();
+            if (frames_ == nullptr || used_ == remaining_)
+                return;
+
+            uint32_t *frame = frames_[used_++];
+            std::memset(frame, 0, sizeof(io::frame_t));
+            for (int y = 0; y != matrix_height; ++y)
+            {
+                for (int x = 0; x != matrix_width; ++x)
+                {
+                    if (!canvas_[y][x])
+                        continue;
+                    int const bit = y * matrix_width + x;
+                    frame[bit / 32] |= 1u << (31 - bit % 32);
+                }
+            }
+            frame[3] = milliseconds_per_frame;
+        }
+
+        void set(int x, int y, uint8_t r, uint8_t g, uint8_t b) override
+        {
+            if (x < 0 || x >= matrix_width || y < 0 || y >= matrix_height)
+                return;
+            canvas_[y][x] = (r | g | b) != 0u;
+        }
+
+    private:
+        bool canvas_[matrix_height][matrix_width];
+        io::frame_t *frames_ = nullptr;
+        std::size_t remaining_ = 0u;
+        std::size_t used_ = 0u;
+    };
+
+    /**
+    * The messages the display cycles through in service: every pump update refreshes the run, frequency, pressure
+    * and flood readings, the pressure wandering a little and the frequency following it, with the odd fault.
+    */
+    std::vector<std::string> message_stream(std::size_t count)
+    {
+        std::vector<std::string> out;
+        out.reserve(count);
+        std::srand(1u);
+        int pressure = 812;
+        for (std::size_t i = 0u; out.size() < count; ++i)
+        {
+            switch (i % 4u)
+            {
+                case 0u: out.push_back("  run: 1"); break;
+                case 1u: out.push_back(std::string{ "  frequency: " } + (pressure < 810 ? "6000" : "4500")); break;
+                case 2u:
+                    pressure = std::clamp(pressure + std::rand() % 3 - 1, 805, 815);
+                    out.push_back("  pressure: " + std::to_string(pressure));
+                    break;
+                default: out.push_back("  flood: 0"); break;
+            }
+            if (std::rand() % 50 == 0)
+                out.push_back("  modbus error: response timeout");
+        }
+        return out;
+    }
+
+    std::array<io::frame_t, 200> anim;
+
+    using bench_clock_t = std::chrono::steady_clock;
+
+    double microseconds(bench_clock_t::duration d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    template <class Canvas>
+    double scroll_fps(Canvas &canvas, char const *text, std::size_t scrolls, uint64_t &frames)
+    {
+        frames = 0u;
+        auto const start = bench_clock_t::now();
+        for (std::size_t i = 0u; i != scrolls; ++i)
+            frames += canvas.render(text, Font_5x7, milliseconds_per_frame, anim.data(), sizeof(anim)) / sizeof(io::frame_t);
+        return frames / (microseconds(bench_clock_t::now() - start) / 1e6);
+    }
+
+    template <class Canvas>
+    uint32_t render(Canvas &canvas, std::string const &text, io::frame_t *frames, uint32_t bytes)
+    {
+        return canvas.render(text.c_str(), Font_5x7, milliseconds_per_frame, frames, bytes);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t const iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000u;
+    std::vector<std::string> const messages = message_stream(iterations);
+
+    static pixel_canvas_t pixels;
+    static io::scroll_canvas_t canvas;
+
+    // A 40 character scroll, longer than any reading or modbus error.
+    char const *const long_text = "  modbus error: slave device failure 1234";
+    std::size_t const scrolls = std::max<std::size_t>(iterations / 20u, 1u);
+    uint64_t scroll_frames = 0u;
+    double const fps_before = scroll_fps(pixels, long_text, scrolls, scroll_frames);
+    double const fps_after = scroll_fps(canvas, long_text, scrolls, scroll_frames);
+
+    // Both renderers have to draw every frame of every message identically.
+    std::array<io::frame_t, 200> reference;
+    std::size_t mismatches = 0u;
+    for (std::string const &m : { std::string{ long_text }, std::string{ "  pressure: 812" }, std::string{ "  run: 0" } })
+    {
+        uint32_t const bytes = render(pixels, m, reference.data(), sizeof(reference));
+        if (render(canvas, m, anim.data(), sizeof(anim)) != bytes || std::memcmp(anim.data(), reference.data(), bytes) != 0)
+            ++mismatches;
+    }
+
+    uint64_t frames = 0u;
+    auto start = bench_clock_t::now();
+    for (auto const &m : messages)
+        frames += render(canvas, m, anim.data(), sizeof(anim)) / sizeof(io::frame_t);
+    double const uncached = microseconds(bench_clock_t::now() - start);
+
+    // The same stream through the cache, as the display plays it.
+    static io::frame_cache_t cache;
+    start = bench_clock_t::now();
+    for (auto const &m : messages)
+    {
+        std::string_view const text{ m };
+        if (cache.find(text))
+            continue;
+        io::frame_cache_t::entry_t const space = cache.reserve(text, static_cast<uint32_t>(m.size() + 2u) * 5u);
+        (void)cache.commit(render(canvas, m, space.frames, space.bytes));
+    }
+    double const cached = microseconds(bench_clock_t::now() - start);
+
+    // Every hit has to replay exactly what rendering the text again would produce.
+    static io::frame_cache_t check;
+    for (auto const &m : messages)
+    {
+        std::string_view const text{ m };
+        if (auto hit = check.find(text))
+        {
+            uint32_t const bytes = render(pixels, m, reference.data(), sizeof(reference));
+            if (bytes != hit->bytes || std::memcmp(hit->frames, reference.data(), bytes) != 0)
+                ++mismatches;
+            continue;
+        }
+        io::frame_cache_t::entry_t const space = check.reserve(text, static_cast<uint32_t>(m.size() + 2u) * 5u);
+        (void)check.commit(render(canvas, m, space.frames, space.bytes));
+    }
+
+    std::printf("40 character scroll: %llu frames, per pixel set(): %.0f fps, packed blitter: %.0f fps (x%.1f)\n",
+        static_cast<unsigned long long>(scroll_frames / scrolls), fps_before, fps_after, fps_after / fps_before);
+
+    io::frame_cache_stats_t const &s = cache.stats();
+    double const n = static_cast<double>(messages.size());
+    std::printf("messages: %zu, frames/message: %.1f, cache frames: %u\n",
+        messages.size(), static_cast<double>(frames) / n, io::frame_cache_frames);
+    std::printf("render: %.2f us/message\n", uncached / n);
+    std::printf("cached: %.2f us/message (hits=%u misses=%u evictions=%u, hit rate %.1f%%)\n",
+        cached / n, s.hits, s.misses, s.evictions, 100.0 * s.hits / n);
+    std::printf("frame mismatches: %zu\n", mismatches);
+    return mismatches == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+}
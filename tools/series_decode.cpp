@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2025 Ben McCart
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and
+ * to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+ * the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+ * THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+* Host side reader for the controller's pressure/frequency history (PMPCTRL.TS).  Loads every block of every file
+* given into memory, reports how long that took, then exports the points as CSV.
+*
+* Build: g++ -std=c++17 -O2 -Iinclude tools/series_decode.cpp -o series_decode
+* Usage: series_decode PMPCTRL.TS [more files...] > series.csv
+*        series_decode --summary PMPCTRL.TS
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "series_format.hpp"
+
+namespace
+{
+    bool load(std::string const &path, std::vector<io::series_point_t> &points, std::size_t &blocks)
+    {
+        std::ifstream in{ path, std::ios::binary };
+        if (!in)
+        {
+            std::cerr << path << ": cannot open\n";
+            return false;
+        }
+
+        std::vector<uint8_t> const data{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+        for (std::size_t offset = 0u; offset + io::series_block_size <= data.size(); offset += io::series_block_size)
+        {
+            bool const valid = io::decode_series_block(data.data() + offset, [&](io::series_point_t const &point)
+            {
+                points.push_back(point);
+            });
+
+            if (valid)
+                ++blocks;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool summary = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view{ argv[i] } == "--summary")
+            summary = true;
+        else
+            paths.emplace_back(argv[i]);
+    }
+
+    if (paths.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " [--summary] <series file>...\n";
+        return 2;
+    }
+
+    std::vector<io::series_point_t> points;
+    std::size_t blocks = 0u;
+    bool ok = true;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::string const &path : paths)
+        ok = load(path, points, blocks) && ok;
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << blocks << " blocks, " << points.size() << " points loaded in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us\n";
+
+    if (!summary)
+    {
+        std::ios::sync_with_stdio(false);
+        std::cout << "time_ms,pressure,frequency,run\n";
+        for (io::series_point_t const &p : points)
+            std::cout << p.time_ms << ',' << p.pressure << ',' << p.frequency << ',' << p.run << '\n';
+    }
+
+    return ok ? 0 : 1;
+}